@@ -53,7 +53,8 @@ const int ID_PCE = 5;
 const int ID_FIL = 6;
 const int ID_END = 7;
 
-const size_t EXTRA_WORKSPACE_BYTES = 16;
+// Including 8 bytes for the word-at-a-time loads of read_bits() and the Huffman decoder
+const size_t EXTRA_WORKSPACE_BYTES = 24;
 
 inline bool CheckOverrun(size_t lenBytes, size_t pos)
 {
@@ -66,6 +67,25 @@ void ByteAlignment(size_t &pos)
     pos = (pos + 7) / 8 * 8;
 }
 
+// Appends the bits from "pos" to "endPos" while whole bytes remain.
+void AppendBytes(std::vector<uint8_t> &dest, const uint8_t *aac, size_t &pos, size_t endPos)
+{
+    size_t n = pos < endPos ? (endPos - pos) / 8 : 0;
+    size_t destPos = dest.size();
+    dest.resize(destPos + n);
+    // 7 bytes per word
+    for (; n >= 7; n -= 7) {
+        uint64_t word = load_be64(aac + (pos >> 3)) << (pos & 7);
+        for (int i = 0; i < 7; ++i) {
+            dest[destPos++] = static_cast<uint8_t>(word >> (56 - 8 * i));
+        }
+        pos += 56;
+    }
+    for (; n > 0; --n) {
+        dest[destPos++] = static_cast<uint8_t>(read_bits(aac, pos, 8));
+    }
+}
+
 bool SingleChannelElement(const uint8_t *aac, size_t lenBytes, size_t &pos, bool is32khz)
 {
     pos += 4;
@@ -445,7 +465,6 @@ bool SyncPayload(std::vector<uint8_t> &workspace, const uint8_t *payload, size_t
 
 void SkipPayload(std::vector<uint8_t> &workspace, size_t workspaceLenBytes)
 {
-    workspace.resize(workspaceLenBytes);
     size_t i = 0;
     while (workspaceLenBytes - i > 0) {
         if (workspace[i] != 0xff) {
@@ -473,6 +492,7 @@ void SkipPayload(std::vector<uint8_t> &workspace, size_t workspaceLenBytes)
     }
 
     // Carry over the remaining payload.
+    workspace.resize(workspaceLenBytes);
     workspace.erase(workspace.begin(), workspace.begin() + i);
     if (!workspace.empty()) {
         assert(workspace[0] == 0xff);
@@ -610,9 +630,7 @@ bool TransmuxDualMono(std::vector<uint8_t> &destLeft, std::vector<uint8_t> &dest
 
                     // Left individual_channel_stream
                     size_t leftPos = scePos;
-                    while (leftPos + 7 < sceEndPos) {
-                        dest.push_back(static_cast<uint8_t>(read_bits(aac, leftPos, 8)));
-                    }
+                    AppendBytes(dest, aac, leftPos, sceEndPos);
                     int leftRemain = static_cast<int>(sceEndPos - leftPos);
                     if (leftRemain != 0) {
                         dest.push_back(static_cast<uint8_t>(read_bits(aac, leftPos, leftRemain)) << (8 - leftRemain));
@@ -623,9 +641,7 @@ bool TransmuxDualMono(std::vector<uint8_t> &destLeft, std::vector<uint8_t> &dest
                     }
                 }
                 // SCE or Right individual_channel_stream
-                while (scePos + 7 < sceEndPos) {
-                    dest.push_back(static_cast<uint8_t>(read_bits(aac, scePos, 8)));
-                }
+                AppendBytes(dest, aac, scePos, sceEndPos);
                 int sceRemain = static_cast<int>(sceEndPos - scePos);
                 if (sceRemain != 0) {
                     dest.push_back((static_cast<uint8_t>(read_bits(aac, scePos, sceRemain)) << (8 - sceRemain)) | (0xe0 >> sceRemain));
@@ -771,9 +787,7 @@ bool TransmuxMonoToStereo(std::vector<uint8_t> &dest, std::vector<uint8_t> &work
 
                 // Left individual_channel_stream
                 size_t leftPos = scePos;
-                while (leftPos + 7 < sceEndPos) {
-                    dest.push_back(static_cast<uint8_t>(read_bits(aac, leftPos, 8)));
-                }
+                AppendBytes(dest, aac, leftPos, sceEndPos);
                 int leftRemain = static_cast<int>(sceEndPos - leftPos);
                 if (leftRemain != 0) {
                     dest.push_back(static_cast<uint8_t>(read_bits(aac, leftPos, leftRemain)) << (8 - leftRemain));
@@ -783,9 +797,7 @@ bool TransmuxMonoToStereo(std::vector<uint8_t> &dest, std::vector<uint8_t> &work
                     dest.back() |= static_cast<uint8_t>(read_bits(aac, scePos, 8 - leftRemain));
                 }
             }
-            while (scePos + 7 < sceEndPos) {
-                dest.push_back(static_cast<uint8_t>(read_bits(aac, scePos, 8)));
-            }
+            AppendBytes(dest, aac, scePos, sceEndPos);
             int sceRemain = static_cast<int>(sceEndPos - scePos);
             if (sceRemain != 0) {
                 dest.push_back((static_cast<uint8_t>(read_bits(aac, scePos, sceRemain)) << (8 - sceRemain)) | (0xe0 >> sceRemain));
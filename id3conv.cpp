@@ -7,18 +7,15 @@ CID3Converter::CID3Converter()
     , m_insertInappropriate5BytesIntoPesPayload(false)
     , m_forceMonotonousPts(false)
     , m_lastID3Pts(-1)
-    , m_firstPmtPid(0)
+    , m_sharedModel(nullptr)
     , m_captionPid(0)
     , m_superimposePid(0)
-    , m_pcrPid(0)
-    , m_pcr(-1)
     , m_id3Pid(0)
     , m_id3Counter(0)
     , m_pmtCounter(0)
+    , m_lastPmtPid(0)
 {
-    static const PAT zeroPat = {};
-    m_pat = zeroPat;
-    m_firstPmtPsi = zeroPat.psi;
+    std::fill(m_pidActions, m_pidActions + 8192, static_cast<uint8_t>(PID_ACTION_PASS));
 }
 
 void CID3Converter::SetOption(int flags)
@@ -29,59 +26,40 @@ void CID3Converter::SetOption(int flags)
     m_forceMonotonousPts = !!(flags & 8);
 }
 
-void CID3Converter::AddPacket(const uint8_t *packet)
+void CID3Converter::AddPacket(const TS_HEADERS &headers, size_t index)
 {
+    const uint8_t *packet = headers.packet[index];
     if (!m_enabled) {
-        m_packets.insert(m_packets.end(), packet, packet + 188);
+        m_packets.AddRef(packet);
         return;
     }
+    if (!m_sharedModel) {
+        m_model.AddPacket(headers, index);
+    }
 
-    int unitStart = extract_ts_header_unit_start(packet);
-    int pid = extract_ts_header_pid(packet);
-    int adaptation = extract_ts_header_adaptation(packet);
-    int counter = extract_ts_header_counter(packet);
-    int payloadSize = get_ts_payload_size(packet);
-    const uint8_t *payload = packet + 188 - payloadSize;
+    int unitStart = headers.unit_start[index];
+    int pid = headers.pid[index];
+    int counter = headers.counter[index];
+    int payloadSize = 188 - headers.payload_offset[index];
+    const uint8_t *payload = packet + headers.payload_offset[index];
 
     if (pid == 0) {
-        extract_pat(&m_pat, payload, payloadSize, unitStart, counter);
-        auto itFirstPmt = std::find_if(m_pat.pmt.begin(), m_pat.pmt.end(), [](const PMT_REF &pmt) { return pmt.program_number != 0; });
-        if (m_firstPmtPid != 0 && (itFirstPmt == m_pat.pmt.end() || itFirstPmt->pmt_pid != m_firstPmtPid)) {
-            m_firstPmtPid = 0;
-            static const PSI zeroPsi = {};
-            m_firstPmtPsi = zeroPsi;
-        }
-        if (itFirstPmt != m_pat.pmt.end()) {
-            m_firstPmtPid = itFirstPmt->pmt_pid;
-        }
-        m_packets.insert(m_packets.end(), packet, packet + 188);
+        m_packets.AddRef(packet);
     }
-    else if (pid == m_firstPmtPid) {
-        int done;
-        do {
-            done = extract_psi(&m_firstPmtPsi, payload, payloadSize, unitStart, counter);
-            if (m_firstPmtPsi.version_number && m_firstPmtPsi.table_id == 2) {
-                AddPmt(pid, m_firstPmtPsi);
+    else if (pid == GetModel().GetFirstPmtPid()) {
+        const std::vector<PSI> &sections = GetModel().GetPmtSections();
+        for (auto it = sections.begin(); it != sections.end(); ++it) {
+            if (it->table_id == 2) {
+                AddPmt(pid, *it);
             }
         }
-        while (!done);
     }
-    else if (pid == m_pcrPid) {
-        if (adaptation & 2) {
-            int adaptationLength = packet[4];
-            if (adaptationLength >= 6 && !!(packet[5] & 0x10)) {
-                m_pcr = (packet[10] >> 7) |
-                        (packet[9] << 1) |
-                        (packet[8] << 9) |
-                        (packet[7] << 17) |
-                        (static_cast<int64_t>(packet[6]) << 25);
-            }
-        }
-        m_packets.insert(m_packets.end(), packet, packet + 188);
+    else if (pid == GetModel().GetPcrPid()) {
+        m_packets.AddRef(packet);
     }
-    else if (m_removePidSet.count(pid)) {
-        if (pid == m_captionPid || pid == m_superimposePid) {
-            auto &pesPair = pid == m_captionPid ? m_captionPes : m_superimposePes;
+    else if (m_pidActions[pid] != PID_ACTION_PASS) {
+        if (m_pidActions[pid] != PID_ACTION_REMOVE) {
+            auto &pesPair = m_pidActions[pid] == PID_ACTION_CAPTION ? m_captionPes : m_superimposePes;
             int &pesCounter = pesPair.first;
             std::vector<uint8_t> &pes = pesPair.second;
             if (unitStart) {
@@ -110,7 +88,7 @@ void CID3Converter::AddPacket(const uint8_t *packet)
         }
     }
     else {
-        m_packets.insert(m_packets.end(), packet, packet + 188);
+        m_packets.AddRef(packet);
     }
 }
 
@@ -118,15 +96,18 @@ void CID3Converter::AddPmt(int pid, const PSI &psi)
 {
     const uint8_t PES_PRIVATE_DATA = 0x06;
 
+    if (psi.unchanged && m_lastPmtPid == pid) {
+        // The removed PIDs are the same as the last time
+        AddLastPmtPackets();
+        return;
+    }
+    m_lastPmtPid = 0;
+
     if (psi.section_length < 9) {
         return;
     }
     const uint8_t *table = psi.data;
     int serviceID = (table[3] << 8) | table[4];
-    m_pcrPid = ((table[8] & 0x1f) << 8) | table[9];
-    if (m_pcrPid == 0x1fff) {
-        m_pcr = -1;
-    }
     int programInfoLength = ((table[10] & 0x03) << 8) | table[11];
     int pos = 3 + 9 + programInfoLength;
     if (psi.section_length < pos) {
@@ -134,14 +115,14 @@ void CID3Converter::AddPmt(int pid, const PSI &psi)
     }
 
     // Create PMT
-    m_buf.clear();
-    m_buf.push_back(0);
-    m_buf.insert(m_buf.end(), table, table + pos);
+    m_lastPmt.clear();
+    m_lastPmt.push_back(0);
+    m_lastPmt.insert(m_lastPmt.end(), table, table + pos);
 
     int captionPids[2] = {};
     int superimposePids[2] = {};
     int minRemovePid = 0x2000;
-    m_removePidSet.clear();
+    std::fill(m_pidActions, m_pidActions + 8192, static_cast<uint8_t>(PID_ACTION_PASS));
     int tableLen = 3 + psi.section_length - 4/*CRC32*/;
     while (pos + 4 < tableLen) {
         int streamType = table[pos];
@@ -168,12 +149,12 @@ void CID3Converter::AddPmt(int pid, const PSI &psi)
                     superimposePids[componentTag != 0x38] = esPid;
                 }
                 // Remove from PMT
-                m_removePidSet.emplace(esPid);
+                m_pidActions[esPid] = PID_ACTION_REMOVE;
                 minRemovePid = std::min(esPid, minRemovePid);
             }
             else {
                 // Remain
-                m_buf.insert(m_buf.end(), table + pos, table + pos + 5 + esInfoLength);
+                m_lastPmt.insert(m_lastPmt.end(), table + pos, table + pos + 5 + esInfoLength);
                 if (m_id3Pid == esPid) {
                     // Reassign PID, rare case.
                     m_id3Pid = 0;
@@ -192,6 +173,12 @@ void CID3Converter::AddPmt(int pid, const PSI &psi)
         m_superimposePid = superimposePids[0] ? superimposePids[0] : superimposePids[1];
         m_superimposePes.second.clear();
     }
+    if (m_superimposePid != 0) {
+        m_pidActions[m_superimposePid] = PID_ACTION_SUPERIMPOSE;
+    }
+    if (m_captionPid != 0) {
+        m_pidActions[m_captionPid] = PID_ACTION_CAPTION;
+    }
 
     if (m_id3Pid == 0 && minRemovePid < 0x2000) {
         m_id3Pid = minRemovePid;
@@ -209,35 +196,43 @@ void CID3Converter::AddPmt(int pid, const PSI &psi)
         // Add to 1st descriptor loop
         programInfoLength += sizeof(metadataPointerDesc);
         if (programInfoLength <= 1023) {
-            m_buf[11] = static_cast<uint8_t>(0xf0 | (programInfoLength >> 8));
-            m_buf[12] = static_cast<uint8_t>(programInfoLength);
-            m_buf.insert(m_buf.begin() + 13, metadataPointerDesc, metadataPointerDesc + sizeof(metadataPointerDesc));
+            m_lastPmt[11] = static_cast<uint8_t>(0xf0 | (programInfoLength >> 8));
+            m_lastPmt[12] = static_cast<uint8_t>(programInfoLength);
+            m_lastPmt.insert(m_lastPmt.begin() + 13, metadataPointerDesc, metadataPointerDesc + sizeof(metadataPointerDesc));
         }
         // Add to 2nd descriptor loop
-        m_buf.push_back(0x15);
-        m_buf.push_back(static_cast<uint8_t>(0xe0 | (m_id3Pid >> 8)));
-        m_buf.push_back(static_cast<uint8_t>(m_id3Pid));
-        m_buf.push_back(0xf0);
-        m_buf.push_back(static_cast<uint8_t>(sizeof(metadataDesc)));
-        m_buf.insert(m_buf.end(), metadataDesc, metadataDesc + sizeof(metadataDesc));
+        m_lastPmt.push_back(0x15);
+        m_lastPmt.push_back(static_cast<uint8_t>(0xe0 | (m_id3Pid >> 8)));
+        m_lastPmt.push_back(static_cast<uint8_t>(m_id3Pid));
+        m_lastPmt.push_back(0xf0);
+        m_lastPmt.push_back(static_cast<uint8_t>(sizeof(metadataDesc)));
+        m_lastPmt.insert(m_lastPmt.end(), metadataDesc, metadataDesc + sizeof(metadataDesc));
     }
-    m_buf[2] = static_cast<uint8_t>((m_buf[2] & 0xf0) | ((m_buf.size() + 4 - 4) >> 8));
-    m_buf[3] = static_cast<uint8_t>(m_buf.size() + 4 - 4);
-    uint32_t crc = calc_crc32(m_buf.data() + 1, static_cast<int>(m_buf.size() - 1));
-    m_buf.push_back(crc >> 24);
-    m_buf.push_back((crc >> 16) & 0xff);
-    m_buf.push_back((crc >> 8) & 0xff);
-    m_buf.push_back(crc & 0xff);
+    m_lastPmt[2] = static_cast<uint8_t>((m_lastPmt[2] & 0xf0) | ((m_lastPmt.size() + 4 - 4) >> 8));
+    m_lastPmt[3] = static_cast<uint8_t>(m_lastPmt.size() + 4 - 4);
+    uint32_t crc = calc_crc32(m_lastPmt.data() + 1, static_cast<int>(m_lastPmt.size() - 1));
+    m_lastPmt.push_back(crc >> 24);
+    m_lastPmt.push_back((crc >> 16) & 0xff);
+    m_lastPmt.push_back((crc >> 8) & 0xff);
+    m_lastPmt.push_back(crc & 0xff);
 
+    m_lastPmtPid = pid;
+    AddLastPmtPackets();
+}
+
+void CID3Converter::AddLastPmtPackets()
+{
     // Create TS packets
-    for (size_t i = 0; i < m_buf.size(); i += 184) {
-        m_packets.push_back(0x47);
-        m_packets.push_back(static_cast<uint8_t>((i == 0 ? 0x40 : 0) | ((pid >> 8) & 0x1f)));
-        m_packets.push_back(static_cast<uint8_t>(pid));
+    for (size_t i = 0; i < m_lastPmt.size(); i += 184) {
+        uint8_t *packet = m_packets.AddSlot();
+        packet[0] = 0x47;
+        packet[1] = static_cast<uint8_t>((i == 0 ? 0x40 : 0) | ((m_lastPmtPid >> 8) & 0x1f));
+        packet[2] = static_cast<uint8_t>(m_lastPmtPid);
         m_pmtCounter = (m_pmtCounter + 1) & 0x0f;
-        m_packets.push_back(0x10 | m_pmtCounter);
-        m_packets.insert(m_packets.end(), m_buf.begin() + i, m_buf.begin() + std::min(i + 184, m_buf.size()));
-        m_packets.resize(((m_packets.size() - 1) / 188 + 1) * 188, 0xff);
+        packet[3] = 0x10 | m_pmtCounter;
+        size_t len = std::min<size_t>(184, m_lastPmt.size() - i);
+        std::copy(m_lastPmt.begin() + i, m_lastPmt.begin() + i + len, packet + 4);
+        std::fill(packet + 4 + len, packet + 188, 0xff);
     }
 }
 
@@ -264,8 +259,8 @@ void CID3Converter::CheckPrivateDataPes(const std::vector<uint8_t> &pes)
         }
         else if (streamID == PRIVATE_STREAM_2) {
             payloadPos = 6;
-            if (m_pcr >= 0) {
-                pts = m_pcr;
+            if (GetModel().GetPcr() >= 0) {
+                pts = GetModel().GetPcr();
             }
         }
     }
@@ -352,19 +347,20 @@ void CID3Converter::CheckPrivateDataPes(const std::vector<uint8_t> &pes)
 
     // Create TS packets
     for (size_t i = 0; i < m_buf.size(); i += 184) {
-        m_packets.push_back(0x47);
-        m_packets.push_back(static_cast<uint8_t>((i == 0 ? 0x40 : 0) | ((m_id3Pid >> 8) & 0x1f)));
-        m_packets.push_back(static_cast<uint8_t>(m_id3Pid));
+        uint8_t *packet = m_packets.AddSlot();
+        packet[0] = 0x47;
+        packet[1] = static_cast<uint8_t>((i == 0 ? 0x40 : 0) | ((m_id3Pid >> 8) & 0x1f));
+        packet[2] = static_cast<uint8_t>(m_id3Pid);
         m_id3Counter = (m_id3Counter + 1) & 0x0f;
         size_t len = std::min<size_t>(184, m_buf.size() - i);
-        m_packets.push_back((len < 184 ? 0x30 : 0x10) | m_id3Counter);
+        packet[3] = (len < 184 ? 0x30 : 0x10) | m_id3Counter;
         if (len < 184) {
-            m_packets.push_back(static_cast<uint8_t>(183 - len));
+            packet[4] = static_cast<uint8_t>(183 - len);
             if (len < 183) {
-                m_packets.push_back(0x00);
-                m_packets.insert(m_packets.end(), 182 - len, 0xff);
+                packet[5] = 0x00;
+                std::fill(packet + 6, packet + 188 - len, 0xff);
             }
         }
-        m_packets.insert(m_packets.end(), m_buf.begin() + i, m_buf.begin() + i + len);
+        std::copy(m_buf.begin() + i, m_buf.begin() + i + len, packet + 188 - len);
     }
 }
@@ -1,9 +1,9 @@
 #ifndef INCLUDE_ID3CONV_HPP
 #define INCLUDE_ID3CONV_HPP
 
+#include "streammodel.hpp"
 #include "util.hpp"
 #include <stdint.h>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -11,35 +11,48 @@ class CID3Converter
 {
 public:
     CID3Converter();
-    void AddPacket(const uint8_t *packet);
+    void AddPacket(const TS_HEADERS &headers, size_t index);
     void SetOption(int flags);
-    const std::vector<uint8_t> &GetPackets() const { return m_packets; }
-    void ClearPackets() { m_packets.clear(); }
+    // Shares "model" updated with each packet before AddPacket(), instead of modeling the packets internally.
+    void SetStreamModel(const CStreamModel *model) { m_sharedModel = model; }
+    const CPacketList &GetPackets() const { return m_packets; }
+    void ClearPackets() { m_packets.Clear(); }
 
 private:
+    const CStreamModel &GetModel() const { return m_sharedModel ? *m_sharedModel : m_model; }
     void AddPmt(int pid, const PSI &psi);
+    void AddLastPmtPackets();
     void CheckPrivateDataPes(const std::vector<uint8_t> &pes);
 
+    // What AddPacket() does with the packets of each PID, unless the PID is of the first PMT or the PCR
+    enum
+    {
+        PID_ACTION_PASS,
+        PID_ACTION_REMOVE,
+        PID_ACTION_CAPTION,
+        PID_ACTION_SUPERIMPOSE,
+    };
+
     bool m_enabled;
     bool m_treatUnknownPrivateDataAsSuperimpose;
     bool m_insertInappropriate5BytesIntoPesPayload;
     bool m_forceMonotonousPts;
     int64_t m_lastID3Pts;
-    std::vector<uint8_t> m_packets;
-    PAT m_pat;
-    int m_firstPmtPid;
-    PSI m_firstPmtPsi;
-    std::unordered_set<int> m_removePidSet;
+    CPacketList m_packets;
+    CStreamModel m_model;
+    const CStreamModel *m_sharedModel;
+    uint8_t m_pidActions[8192];
     int m_captionPid;
     int m_superimposePid;
     std::pair<int, std::vector<uint8_t>> m_captionPes;
     std::pair<int, std::vector<uint8_t>> m_superimposePes;
-    int m_pcrPid;
-    int64_t m_pcr;
     int m_id3Pid;
     uint8_t m_id3Counter;
     uint8_t m_pmtCounter;
     std::vector<uint8_t> m_buf;
+    std::vector<uint8_t> m_lastPmt;
+    // PID of the PMT that m_lastPmt is created from, or 0 if not reusable
+    int m_lastPmtPid;
 };
 
 #endif
@@ -0,0 +1,72 @@
+#include "pcrpacer.hpp"
+#include <algorithm>
+
+namespace
+{
+const int DETERMINE_DISCONTINUITY_SEC = 2;
+const int DETERMINE_LAGGING_SEC = 1;
+}
+
+CPcrPacer::CPcrPacer()
+    : m_speed(0)
+    , m_sharedModel(nullptr)
+    , m_pcrPid(0)
+    , m_lastPcr(-1)
+    , m_elapsedPcr(0)
+{
+    // The PCR may be carried by the PMT PID
+    m_model.SetPcrOnPmtPid(true);
+}
+
+std::chrono::milliseconds CPcrPacer::AddPacket(const TS_HEADERS &headers, size_t index)
+{
+    const uint8_t *packet = headers.packet[index];
+    if (!m_speed) {
+        return std::chrono::milliseconds(0);
+    }
+    if (!m_sharedModel) {
+        m_model.AddPacket(headers, index);
+    }
+
+    int pid = headers.pid[index];
+    if (GetModel().GetPcrPid() != m_pcrPid) {
+        m_pcrPid = GetModel().GetPcrPid();
+        // Rebase on the next PCR
+        m_lastPcr = -1;
+    }
+
+    if (pid == m_pcrPid && headers.pcr_flag[index]) {
+        int64_t pcr = GetModel().GetPcr();
+        if (pcr >= 0) {
+            bool discontinuity = !!(packet[5] & 0x80);
+            auto nowTime = std::chrono::steady_clock::now();
+            bool rebase = true;
+            if (m_lastPcr >= 0 && !discontinuity) {
+                // Handle wraparound
+                int64_t pcrDiff = (0x200000000 + pcr - m_lastPcr) & 0x1ffffffff;
+                if (pcrDiff < 90000 * DETERMINE_DISCONTINUITY_SEC) {
+                    m_elapsedPcr += pcrDiff;
+                    rebase = false;
+                }
+            }
+            auto releaseTime = m_baseTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(m_elapsedPcr * 100.0 / 90000 / m_speed));
+            if (!rebase && releaseTime + std::chrono::seconds(DETERMINE_LAGGING_SEC) < nowTime) {
+                // Lagging behind (input is too slow etc.), don't try to catch up
+                rebase = true;
+            }
+            if (rebase) {
+                // Don't release earlier than the last packet
+                m_baseTime = std::max(nowTime, m_lastReleaseTime);
+                m_elapsedPcr = 0;
+                releaseTime = m_baseTime;
+            }
+            m_lastPcr = pcr;
+            m_lastReleaseTime = releaseTime;
+            if (releaseTime > nowTime) {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(releaseTime - nowTime);
+            }
+        }
+    }
+    return std::chrono::milliseconds(0);
+}
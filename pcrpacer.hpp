@@ -0,0 +1,34 @@
+#ifndef INCLUDE_PCRPACER_HPP
+#define INCLUDE_PCRPACER_HPP
+
+#include "streammodel.hpp"
+#include "util.hpp"
+#include <stdint.h>
+#include <chrono>
+
+class CPcrPacer
+{
+public:
+    CPcrPacer();
+    // Percentage of real time. 0 means disabled.
+    void SetSpeed(int percent) { m_speed = percent; }
+    bool IsEnabled() const { return m_speed != 0; }
+    // Shares "model" updated with each packet before AddPacket(), instead of modeling the packets internally.
+    void SetStreamModel(const CStreamModel *model) { m_sharedModel = model; }
+    // Returns the time to wait before outputting the packet.
+    std::chrono::milliseconds AddPacket(const TS_HEADERS &headers, size_t index);
+
+private:
+    const CStreamModel &GetModel() const { return m_sharedModel ? *m_sharedModel : m_model; }
+
+    int m_speed;
+    CStreamModel m_model;
+    const CStreamModel *m_sharedModel;
+    int m_pcrPid;
+    int64_t m_lastPcr;
+    int64_t m_elapsedPcr;
+    std::chrono::steady_clock::time_point m_baseTime;
+    std::chrono::steady_clock::time_point m_lastReleaseTime;
+};
+
+#endif
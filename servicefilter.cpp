@@ -13,6 +13,9 @@ CServiceFilter::CServiceFilter()
     , m_superimposeMode(0)
     , m_captionInsertManagementPacket(false)
     , m_superimposeInsertManagementPacket(false)
+    , m_sharedModel(nullptr)
+    , m_pmtPid(0)
+    , m_nitPid(0)
     , m_videoPid(0)
     , m_audio1Pid(0)
     , m_audio2Pid(0)
@@ -35,10 +38,15 @@ CServiceFilter::CServiceFilter()
     , m_audio2PtsPcrDiff(-1)
     , m_captionManagementPcr(-1)
     , m_superimposeManagementPcr(-1)
+    , m_patTransportStreamID(0)
+    , m_patProgramNumber(0)
+    , m_patAddNit(false)
+    , m_lastPmtReusable(false)
+    , m_lastPmtDualMono(false)
 {
-    static const PAT zeroPat = {};
-    m_pat = zeroPat;
-    m_pmtPsi = zeroPat.psi;
+    m_pmtPsi = PSI();
+    UpdatePidActions();
+    CreatePacketTemplates();
 }
 
 void CServiceFilter::SetAudio1Mode(int mode)
@@ -66,26 +74,39 @@ void CServiceFilter::SetSuperimposeMode(int mode)
     m_superimposeInsertManagementPacket = !!(mode & 4);
 }
 
-void CServiceFilter::AddPacket(const uint8_t *packet)
+void CServiceFilter::AddPacket(const TS_HEADERS &headers, size_t index)
 {
+    const uint8_t *packet = headers.packet[index];
     if (m_programNumberOrIndex == 0) {
-        m_packets.insert(m_packets.end(), packet, packet + 188);
+        m_packets.AddRef(packet);
         return;
     }
+    if (!m_sharedModel) {
+        m_model.AddPacket(headers, index);
+    }
 
-    int unitStart = extract_ts_header_unit_start(packet);
-    int pid = extract_ts_header_pid(packet);
-    int adaptation = extract_ts_header_adaptation(packet);
-    int counter = extract_ts_header_counter(packet);
-    int payloadSize = get_ts_payload_size(packet);
-    const uint8_t *payload = packet + 188 - payloadSize;
+    int pid = headers.pid[index];
+    int action = m_pidActions[pid];
+    if (action == PID_ACTION_DROP) {
+        // Not related to the target service
+        return;
+    }
 
-    if (pid == 0) {
-        extract_pat(&m_pat, payload, payloadSize, unitStart, counter);
-        auto itPmt = FindTargetPmtRef(m_pat.pmt);
-        if (itPmt != m_pat.pmt.end()) {
+    int unitStart = headers.unit_start[index];
+    int adaptation = headers.adaptation[index];
+    int counter = headers.counter[index];
+    int payloadSize = 188 - headers.payload_offset[index];
+    const uint8_t *payload = packet + headers.payload_offset[index];
+
+    if (action == PID_ACTION_PAT) {
+        const PAT &pat = GetModel().GetPat();
+        auto itPmt = FindTargetPmtRef(pat.pmt);
+        auto itNit = FindNitRef(pat.pmt);
+        int pmtPid = itPmt != pat.pmt.end() ? itPmt->pmt_pid : 0;
+        int nitPid = itNit != pat.pmt.end() ? itNit->pmt_pid : 0;
+        if (itPmt != pat.pmt.end()) {
             if (unitStart) {
-                AddPat(m_pat.transport_stream_id, itPmt->program_number, FindNitRef(m_pat.pmt) != m_pat.pmt.end());
+                AddPat(pat.transport_stream_id, itPmt->program_number, itNit != pat.pmt.end());
             }
         }
         else {
@@ -96,176 +117,179 @@ void CServiceFilter::AddPacket(const uint8_t *packet)
             m_superimposePid = 0;
             m_pcrPid = 0;
             m_pcr = -1;
+            m_lastPmtReusable = false;
+        }
+        if (pmtPid != m_pmtPid || nitPid != m_nitPid) {
+            m_pmtPid = pmtPid;
+            m_nitPid = nitPid;
+            UpdatePidActions();
         }
     }
     else {
-        auto itPmt = FindTargetPmtRef(m_pat.pmt);
-        if (itPmt != m_pat.pmt.end()) {
-            if (pid == itPmt->pmt_pid) {
-                int done;
-                do {
-                    done = extract_psi(&m_pmtPsi, payload, payloadSize, unitStart, counter);
-                    if (m_pmtPsi.version_number && m_pmtPsi.table_id == 2 && m_pmtPsi.current_next_indicator) {
-                        AddPmt(m_pmtPsi);
-                    }
+        if (action & PID_ACTION_PMT) {
+            int done;
+            do {
+                done = extract_psi(&m_pmtPsi, payload, payloadSize, unitStart, counter);
+                if (m_pmtPsi.version_number && m_pmtPsi.table_id == 2 && m_pmtPsi.current_next_indicator) {
+                    AddPmt(m_pmtPsi);
                 }
-                while (!done);
             }
-            if (pid == m_pcrPid) {
-                if (adaptation & 2) {
-                    int adaptationLength = packet[4];
-                    if (adaptationLength >= 6 && !!(packet[5] & 0x10)) {
-                        if (pid != m_videoPid &&
-                            pid != m_audio1Pid &&
-                            pid != m_audio2Pid &&
-                            pid != m_captionPid &&
-                            pid != m_superimposePid) {
-                            AddPcrAdaptation(packet + 6);
-                        }
-                        m_pcr = (packet[10] >> 7) |
-                                (packet[9] << 1) |
-                                (packet[8] << 9) |
-                                (packet[7] << 17) |
-                                (static_cast<int64_t>(packet[6]) << 25);
-                        if (m_audio1Mode == 1 && m_audio1Pid == 0) {
-                            AddAudioPesPackets(0, (m_pcr + m_audio1PtsPcrDiff) & 0x1ffffffff, m_audio1Pts, m_audio1PesCounter);
-                        }
-                        if ((m_audio2Mode == 1 || (m_audio2Mode == 3 && m_audio1Pid == 0)) && m_audio2Pid == 0 && !m_isAudio1DualMono) {
-                            if (m_audio2PtsPcrDiff < 0) {
-                                m_audio2PtsPcrDiff = m_audio1PtsPcrDiff;
-                            }
-                            AddAudioPesPackets(1, (m_pcr + m_audio2PtsPcrDiff) & 0x1ffffffff, m_audio2Pts, m_audio2PesCounter);
+            while (!done);
+            // The PMT may have changed the action
+            action = m_pidActions[pid];
+        }
+        int route = action & PID_ACTION_ROUTE_MASK;
+        if (action & PID_ACTION_PCR) {
+            if (adaptation & 2) {
+                int adaptationLength = packet[4];
+                if (adaptationLength >= 6 && !!(packet[5] & 0x10)) {
+                    if (route != PID_ACTION_VIDEO &&
+                        route != PID_ACTION_AUDIO1 &&
+                        route != PID_ACTION_AUDIO2 &&
+                        route != PID_ACTION_CAPTION &&
+                        route != PID_ACTION_SUPERIMPOSE) {
+                        AddPcrAdaptation(packet + 6);
+                    }
+                    m_pcr = (packet[10] >> 7) |
+                            (packet[9] << 1) |
+                            (packet[8] << 9) |
+                            (packet[7] << 17) |
+                            (static_cast<int64_t>(packet[6]) << 25);
+                    if (m_audio1Mode == 1 && m_audio1Pid == 0) {
+                        AddAudioPesPackets(0, (m_pcr + m_audio1PtsPcrDiff) & 0x1ffffffff, m_audio1Pts, m_audio1PesCounter);
+                    }
+                    if ((m_audio2Mode == 1 || (m_audio2Mode == 3 && m_audio1Pid == 0)) && m_audio2Pid == 0 && !m_isAudio1DualMono) {
+                        if (m_audio2PtsPcrDiff < 0) {
+                            m_audio2PtsPcrDiff = m_audio1PtsPcrDiff;
                         }
+                        AddAudioPesPackets(1, (m_pcr + m_audio2PtsPcrDiff) & 0x1ffffffff, m_audio2Pts, m_audio2PesCounter);
+                    }
 
-                        static const int INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC = 15;
-                        static const int INSERT_MANAGEMENT_INTERVAL_SEC = INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC - 5;
-                        if (m_captionManagementPcr >= 0 &&
-                            m_captionInsertManagementPacket &&
-                            (m_captionPid != 0 || m_captionMode == 1)) {
-                            int64_t pcrDiff = (0x200000000 + m_pcr - m_captionManagementPcr) & 0x1ffffffff;
-                            if (pcrDiff > 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC) {
-                                if (pcrDiff < 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC * 2) {
-                                    m_captionPesCounter = (m_captionPesCounter + 1) & 0x0f;
-                                    AddCaptionManagementPesPacket(m_pcr, m_captionPesCounter);
-                                }
-                                m_captionManagementPcr = (0x200000000 + m_pcr - 90000 * INSERT_MANAGEMENT_INTERVAL_SEC) & 0x1ffffffff;
+                    static const int INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC = 15;
+                    static const int INSERT_MANAGEMENT_INTERVAL_SEC = INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC - 5;
+                    if (m_captionManagementPcr >= 0 &&
+                        m_captionInsertManagementPacket &&
+                        (m_captionPid != 0 || m_captionMode == 1)) {
+                        int64_t pcrDiff = (0x200000000 + m_pcr - m_captionManagementPcr) & 0x1ffffffff;
+                        if (pcrDiff > 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC) {
+                            if (pcrDiff < 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC * 2) {
+                                m_captionPesCounter = (m_captionPesCounter + 1) & 0x0f;
+                                AddCaptionManagementPesPacket(m_pcr, m_captionPesCounter);
                             }
-                        }
-                        else {
-                            m_captionManagementPcr = m_pcr;
-                        }
-                        if (m_superimposeManagementPcr >= 0 &&
-                            m_superimposeInsertManagementPacket &&
-                            (m_superimposePid != 0 || m_superimposeMode == 1)) {
-                            int64_t pcrDiff = (0x200000000 + m_pcr - m_superimposeManagementPcr) & 0x1ffffffff;
-                            if (pcrDiff > 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC) {
-                                if (pcrDiff < 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC * 2) {
-                                    m_superimposePesCounter = (m_superimposePesCounter + 1) & 0x0f;
-                                    AddSuperimposeManagementPesPacket(m_superimposePesCounter);
-                                }
-                                m_superimposeManagementPcr = (0x200000000 + m_pcr - 90000 * INSERT_MANAGEMENT_INTERVAL_SEC) & 0x1ffffffff;
-                            }
-                        }
-                        else {
-                            m_superimposeManagementPcr = m_pcr;
+                            m_captionManagementPcr = (0x200000000 + m_pcr - 90000 * INSERT_MANAGEMENT_INTERVAL_SEC) & 0x1ffffffff;
                         }
                     }
-                }
-            }
-            if (pid == m_videoPid) {
-                ChangePidAndAddPacket(packet, 0x0100);
-            }
-            else if (pid == m_audio1Pid) {
-                if (AccumulatePesPackets(m_audio1UnitPackets, packet, unitStart)) {
-                    bool passthroughAudio1 = false;
-                    bool copyToAudio2 = false;
-                    m_isAudio1DualMono = m_audio1MuxDualMono && m_audio1StreamType == ADTS_TRANSPORT && TransmuxDualMono(m_audio1UnitPackets);
-                    if (m_isAudio1DualMono) {
-                        // Already added
-                        m_audio1UnitPackets.clear();
-                    }
                     else {
-                        passthroughAudio1 = !m_audio1MuxToStereo || m_audio1StreamType != ADTS_TRANSPORT ||
-                                            !TransmuxMonoToStereo(m_audio1UnitPackets, m_audio1MuxWorkspace, 0x0110, m_audio1PesCounter, m_audio1PtsPcrDiff);
-                        // Copy audio1 to audio2 if needed
-                        copyToAudio2 = m_audio2Mode == 3 && m_audio2Pid == 0;
-                        if (copyToAudio2 && m_audio2MuxToStereo && m_audio1StreamType == ADTS_TRANSPORT &&
-                            TransmuxMonoToStereo(m_audio1UnitPackets, m_audio2MuxWorkspace, 0x0111, m_audio2PesCounter, m_audio2PtsPcrDiff)) {
-                            // Already added
-                            copyToAudio2 = false;
-                        }
-                        if (!passthroughAudio1 && !copyToAudio2) {
-                            m_audio1UnitPackets.clear();
-                        }
+                        m_captionManagementPcr = m_pcr;
                     }
-                    // Add packets
-                    for (size_t i = 0; i + 188 <= m_audio1UnitPackets.size(); i += 188) {
-                        const uint8_t *packet_ = m_audio1UnitPackets.data() + i;
-                        int payloadSize_ = get_ts_payload_size(packet_);
-                        const uint8_t *payload_ = packet_ + 188 - payloadSize_;
-                        int64_t pts = GetAudioPresentationTimeStamp(i == 0, payload_, payloadSize_);
-                        if (passthroughAudio1) {
-                            if (pts >= 0 && m_pcr >= 0) {
-                                m_audio1PtsPcrDiff = 0x200000000 + pts - m_pcr;
+                    if (m_superimposeManagementPcr >= 0 &&
+                        m_superimposeInsertManagementPacket &&
+                        (m_superimposePid != 0 || m_superimposeMode == 1)) {
+                        int64_t pcrDiff = (0x200000000 + m_pcr - m_superimposeManagementPcr) & 0x1ffffffff;
+                        if (pcrDiff > 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC) {
+                            if (pcrDiff < 90000 * INSERT_MANAGEMENT_DETERMINE_ABSENCE_SEC * 2) {
+                                m_superimposePesCounter = (m_superimposePesCounter + 1) & 0x0f;
+                                AddSuperimposeManagementPesPacket(m_superimposePesCounter);
                             }
-                            m_audio1PesCounter = (m_audio1PesCounter + 1) & 0x0f;
-                            ChangePidAndAddPacket(packet_, 0x0110, m_audio1PesCounter);
-                        }
-                        if (copyToAudio2) {
-                            // Copy audio1 to audio2
-                            if (pts >= 0 && m_pcr >= 0) {
-                                m_audio2PtsPcrDiff = 0x200000000 + pts - m_pcr;
-                            }
-                            m_audio2PesCounter = (m_audio2PesCounter + 1) & 0x0f;
-                            ChangePidAndAddPacket(packet_, 0x0111, m_audio2PesCounter);
+                            m_superimposeManagementPcr = (0x200000000 + m_pcr - 90000 * INSERT_MANAGEMENT_INTERVAL_SEC) & 0x1ffffffff;
                         }
                     }
-                    m_audio1UnitPackets.clear();
+                    else {
+                        m_superimposeManagementPcr = m_pcr;
+                    }
                 }
             }
-            else if (pid == m_audio2Pid) {
-                if (AccumulatePesPackets(m_audio2UnitPackets, packet, unitStart)) {
-                    if (m_audio2MuxToStereo && m_audio2StreamType == ADTS_TRANSPORT &&
-                        TransmuxMonoToStereo(m_audio2UnitPackets, m_audio2MuxWorkspace, 0x0111, m_audio2PesCounter, m_audio2PtsPcrDiff)) {
+        }
+        if (route == PID_ACTION_VIDEO) {
+            ChangePidAndAddInputPacket(packet, 0x0100);
+        }
+        else if (route == PID_ACTION_AUDIO1) {
+            if (AccumulatePesPackets(m_audio1UnitPackets, packet, unitStart)) {
+                bool passthroughAudio1 = false;
+                bool copyToAudio2 = false;
+                m_isAudio1DualMono = m_audio1MuxDualMono && m_audio1StreamType == ADTS_TRANSPORT && TransmuxDualMono(m_audio1UnitPackets);
+                if (m_isAudio1DualMono) {
+                    // Already added
+                    m_audio1UnitPackets.clear();
+                }
+                else {
+                    passthroughAudio1 = !m_audio1MuxToStereo || m_audio1StreamType != ADTS_TRANSPORT ||
+                                        !TransmuxMonoToStereo(m_audio1UnitPackets, m_audio1MuxWorkspace, 0x0110, m_audio1PesCounter, m_audio1PtsPcrDiff);
+                    // Copy audio1 to audio2 if needed
+                    copyToAudio2 = m_audio2Mode == 3 && m_audio2Pid == 0;
+                    if (copyToAudio2 && m_audio2MuxToStereo && m_audio1StreamType == ADTS_TRANSPORT &&
+                        TransmuxMonoToStereo(m_audio1UnitPackets, m_audio2MuxWorkspace, 0x0111, m_audio2PesCounter, m_audio2PtsPcrDiff)) {
                         // Already added
-                        m_audio2UnitPackets.clear();
+                        copyToAudio2 = false;
+                    }
+                    if (!passthroughAudio1 && !copyToAudio2) {
+                        m_audio1UnitPackets.clear();
                     }
-                    // Add packets
-                    for (size_t i = 0; i + 188 <= m_audio2UnitPackets.size(); i += 188) {
-                        const uint8_t *packet_ = m_audio2UnitPackets.data() + i;
-                        int payloadSize_ = get_ts_payload_size(packet_);
-                        const uint8_t *payload_ = packet_ + 188 - payloadSize_;
-                        int64_t pts = GetAudioPresentationTimeStamp(i == 0, payload_, payloadSize_);
+                }
+                // Add packets
+                for (size_t i = 0; i + 188 <= m_audio1UnitPackets.size(); i += 188) {
+                    const uint8_t *packet_ = m_audio1UnitPackets.data() + i;
+                    int payloadSize_ = get_ts_payload_size(packet_);
+                    const uint8_t *payload_ = packet_ + 188 - payloadSize_;
+                    int64_t pts = GetAudioPresentationTimeStamp(i == 0, payload_, payloadSize_);
+                    if (passthroughAudio1) {
+                        if (pts >= 0 && m_pcr >= 0) {
+                            m_audio1PtsPcrDiff = 0x200000000 + pts - m_pcr;
+                        }
+                        m_audio1PesCounter = (m_audio1PesCounter + 1) & 0x0f;
+                        ChangePidAndAddPacket(packet_, 0x0110, m_audio1PesCounter);
+                    }
+                    if (copyToAudio2) {
+                        // Copy audio1 to audio2
                         if (pts >= 0 && m_pcr >= 0) {
                             m_audio2PtsPcrDiff = 0x200000000 + pts - m_pcr;
                         }
                         m_audio2PesCounter = (m_audio2PesCounter + 1) & 0x0f;
                         ChangePidAndAddPacket(packet_, 0x0111, m_audio2PesCounter);
                     }
-                    m_audio2UnitPackets.clear();
                 }
+                m_audio1UnitPackets.clear();
             }
-            else if (pid == m_captionPid) {
-                m_captionManagementPcr = m_pcr;
-                m_captionPesCounter = m_captionPesCounter > 0x0f ? 0x10 | (counter & 0x0f) : (m_captionPesCounter + 1) & 0x0f;
-                ChangePidAndAddPacket(packet, 0x0130, m_captionPesCounter & 0x0f);
-            }
-            else if (pid == m_superimposePid) {
-                m_superimposeManagementPcr = m_pcr;
-                m_superimposePesCounter = m_superimposePesCounter > 0x0f ? 0x10 | (counter & 0x0f) : (m_superimposePesCounter + 1) & 0x0f;
-                ChangePidAndAddPacket(packet, 0x0138, m_superimposePesCounter & 0x0f);
-            }
-            else if (pid < 0x0030) {
-                m_packets.insert(m_packets.end(), packet, packet + 188);
-            }
-            else {
-                auto itNit = FindNitRef(m_pat.pmt);
-                if (itNit != m_pat.pmt.end() && pid == itNit->pmt_pid) {
-                    // NIT pid should be 0x0010. This case is unusual.
-                    ChangePidAndAddPacket(packet, 0x0010);
+        }
+        else if (route == PID_ACTION_AUDIO2) {
+            if (AccumulatePesPackets(m_audio2UnitPackets, packet, unitStart)) {
+                if (m_audio2MuxToStereo && m_audio2StreamType == ADTS_TRANSPORT &&
+                    TransmuxMonoToStereo(m_audio2UnitPackets, m_audio2MuxWorkspace, 0x0111, m_audio2PesCounter, m_audio2PtsPcrDiff)) {
+                    // Already added
+                    m_audio2UnitPackets.clear();
+                }
+                // Add packets
+                for (size_t i = 0; i + 188 <= m_audio2UnitPackets.size(); i += 188) {
+                    const uint8_t *packet_ = m_audio2UnitPackets.data() + i;
+                    int payloadSize_ = get_ts_payload_size(packet_);
+                    const uint8_t *payload_ = packet_ + 188 - payloadSize_;
+                    int64_t pts = GetAudioPresentationTimeStamp(i == 0, payload_, payloadSize_);
+                    if (pts >= 0 && m_pcr >= 0) {
+                        m_audio2PtsPcrDiff = 0x200000000 + pts - m_pcr;
+                    }
+                    m_audio2PesCounter = (m_audio2PesCounter + 1) & 0x0f;
+                    ChangePidAndAddPacket(packet_, 0x0111, m_audio2PesCounter);
                 }
+                m_audio2UnitPackets.clear();
             }
         }
+        else if (route == PID_ACTION_CAPTION) {
+            m_captionManagementPcr = m_pcr;
+            m_captionPesCounter = m_captionPesCounter > 0x0f ? 0x10 | (counter & 0x0f) : (m_captionPesCounter + 1) & 0x0f;
+            ChangePidAndAddInputPacket(packet, 0x0130, m_captionPesCounter & 0x0f);
+        }
+        else if (route == PID_ACTION_SUPERIMPOSE) {
+            m_superimposeManagementPcr = m_pcr;
+            m_superimposePesCounter = m_superimposePesCounter > 0x0f ? 0x10 | (counter & 0x0f) : (m_superimposePesCounter + 1) & 0x0f;
+            ChangePidAndAddInputPacket(packet, 0x0138, m_superimposePesCounter & 0x0f);
+        }
+        else if (route == PID_ACTION_PASS) {
+            m_packets.AddRef(packet);
+        }
+        else if (route == PID_ACTION_NIT) {
+            // NIT pid should be 0x0010. This case is unusual.
+            ChangePidAndAddInputPacket(packet, 0x0010);
+        }
     }
 }
 
@@ -292,53 +316,73 @@ std::vector<PMT_REF>::const_iterator CServiceFilter::FindTargetPmtRef(const std:
 
 void CServiceFilter::AddPat(int transportStreamID, int programNumber, bool addNit)
 {
-    // Create PAT
-    m_buf.assign(9, 0);
-    m_buf[1] = 0x00;
-    m_buf[2] = 0xb0;
-    m_buf[3] = addNit ? 17 : 13;
-    m_buf[4] = static_cast<uint8_t>(transportStreamID >> 8);
-    m_buf[5] = static_cast<uint8_t>(transportStreamID);
-    m_buf[6] = m_lastPat.size() > 6 ? m_lastPat[6] : 0xc1;
-    if (addNit) {
-        m_buf.push_back(0);
-        m_buf.push_back(0);
-        m_buf.push_back(0xe0);
-        m_buf.push_back(0x10);
-    }
-    m_buf.push_back(static_cast<uint8_t>(programNumber >> 8));
-    m_buf.push_back(static_cast<uint8_t>(programNumber));
-    // PMT_PID=0x01f0
-    m_buf.push_back(0xe1);
-    m_buf.push_back(0xf0);
-    if (m_lastPat.size() == m_buf.size() + 4 &&
-        std::equal(m_buf.begin(), m_buf.end(), m_lastPat.begin())) {
-        // Copy CRC
-        m_buf.insert(m_buf.end(), m_lastPat.end() - 4, m_lastPat.end());
-    }
-    else {
-        // Increment version number
-        m_buf[6] = 0xc1 | (((m_buf[6] >> 1) + 1) & 0x1f) << 1;
-        uint32_t crc = calc_crc32(m_buf.data() + 1, static_cast<int>(m_buf.size() - 1));
-        m_buf.push_back(crc >> 24);
-        m_buf.push_back((crc >> 16) & 0xff);
-        m_buf.push_back((crc >> 8) & 0xff);
-        m_buf.push_back(crc & 0xff);
-        m_lastPat = m_buf;
+    if (m_lastPat.empty() || transportStreamID != m_patTransportStreamID ||
+        programNumber != m_patProgramNumber || addNit != m_patAddNit) {
+        m_patTransportStreamID = transportStreamID;
+        m_patProgramNumber = programNumber;
+        m_patAddNit = addNit;
+        // Create PAT
+        m_buf.assign(9, 0);
+        m_buf[1] = 0x00;
+        m_buf[2] = 0xb0;
+        m_buf[3] = addNit ? 17 : 13;
+        m_buf[4] = static_cast<uint8_t>(transportStreamID >> 8);
+        m_buf[5] = static_cast<uint8_t>(transportStreamID);
+        m_buf[6] = m_lastPat.size() > 6 ? m_lastPat[6] : 0xc1;
+        if (addNit) {
+            m_buf.push_back(0);
+            m_buf.push_back(0);
+            m_buf.push_back(0xe0);
+            m_buf.push_back(0x10);
+        }
+        m_buf.push_back(static_cast<uint8_t>(programNumber >> 8));
+        m_buf.push_back(static_cast<uint8_t>(programNumber));
+        // PMT_PID=0x01f0
+        m_buf.push_back(0xe1);
+        m_buf.push_back(0xf0);
+        if (m_lastPat.size() == m_buf.size() + 4 &&
+            std::equal(m_buf.begin(), m_buf.end(), m_lastPat.begin())) {
+            // Copy CRC
+            m_buf.insert(m_buf.end(), m_lastPat.end() - 4, m_lastPat.end());
+        }
+        else {
+            // Increment version number
+            m_buf[6] = 0xc1 | (((m_buf[6] >> 1) + 1) & 0x1f) << 1;
+            uint32_t crc = calc_crc32(m_buf.data() + 1, static_cast<int>(m_buf.size() - 1));
+            m_buf.push_back(crc >> 24);
+            m_buf.push_back((crc >> 16) & 0xff);
+            m_buf.push_back((crc >> 8) & 0xff);
+            m_buf.push_back(crc & 0xff);
+            m_lastPat = m_buf;
+        }
+
+        // Create TS packet, whose counter is set later
+        m_patPacket[0] = 0x47;
+        m_patPacket[1] = 0x40;
+        m_patPacket[2] = 0x00;
+        m_patPacket[3] = 0x10;
+        std::copy(m_buf.begin(), m_buf.end(), m_patPacket + 4);
+        std::fill(m_patPacket + 4 + m_buf.size(), m_patPacket + 188, 0xff);
     }
 
-    // Create TS packet
-    m_packets.push_back(0x47);
-    m_packets.push_back(0x40);
-    m_packets.push_back(0x00);
+    uint8_t *packet = m_packets.AddSlot();
+    std::copy(m_patPacket, m_patPacket + 188, packet);
     m_patCounter = (m_patCounter + 1) & 0x0f;
-    m_packets.push_back(0x10 | m_patCounter);
-    m_packets.insert(m_packets.end(), m_buf.begin(), m_buf.end());
-    m_packets.resize((m_packets.size() / 188 + 1) * 188, 0xff);
+    packet[3] = 0x10 | m_patCounter;
 }
 
 void CServiceFilter::AddPmt(const PSI &psi)
 {
+    if (psi.unchanged && m_lastPmtReusable && m_lastPmtDualMono == m_isAudio1DualMono) {
+        // The stream PIDs are the same as the last time
+        if (m_pcrPid == 0x1fff) {
+            m_pcr = -1;
+        }
+        AddLastPmtPackets();
+        return;
+    }
+    m_lastPmtReusable = false;
+
     if (psi.section_length < 9) {
         return;
     }
@@ -351,6 +395,7 @@ void CServiceFilter::AddPmt(const PSI &psi)
     int programInfoLength = ((table[10] & 0x03) << 8) | table[11];
     int pos = 3 + 9 + programInfoLength;
     if (psi.section_length < pos) {
+        UpdatePidActions();
         return;
     }
 
@@ -468,6 +513,7 @@ void CServiceFilter::AddPmt(const PSI &psi)
         m_audio2UnitPackets.clear();
         m_audio2MuxWorkspace.clear();
     }
+    UpdatePidActions();
 
     if (m_videoPid != 0) {
         m_buf.push_back(table[videoDescPos]);
@@ -618,106 +664,216 @@ void CServiceFilter::AddPmt(const PSI &psi)
         m_buf.push_back((crc >> 8) & 0xff);
         m_buf.push_back(crc & 0xff);
         m_lastPmt = m_buf;
+
+        // Create TS packets, whose counters are set later
+        m_lastPmtPackets.clear();
+        for (size_t i = 0; i < m_lastPmt.size(); i += 184) {
+            m_lastPmtPackets.push_back(0x47);
+            // PMT_PID=0x01f0
+            m_lastPmtPackets.push_back((i == 0 ? 0x40 : 0) | 0x01);
+            m_lastPmtPackets.push_back(0xf0);
+            m_lastPmtPackets.push_back(0x10);
+            m_lastPmtPackets.insert(m_lastPmtPackets.end(), m_lastPmt.begin() + i, m_lastPmt.begin() + std::min(i + 184, m_lastPmt.size()));
+            m_lastPmtPackets.resize(((m_lastPmtPackets.size() - 1) / 188 + 1) * 188, 0xff);
+        }
     }
+    m_lastPmtReusable = true;
+    m_lastPmtDualMono = m_isAudio1DualMono;
+    AddLastPmtPackets();
+}
 
-    // Create TS packets
-    for (size_t i = 0; i < m_buf.size(); i += 184) {
-        m_packets.push_back(0x47);
-        // PMT_PID=0x01f0
-        m_packets.push_back((i == 0 ? 0x40 : 0) | 0x01);
-        m_packets.push_back(0xf0);
+void CServiceFilter::UpdatePidActions()
+{
+    std::fill(m_pidActions, m_pidActions + 8192, static_cast<uint8_t>(PID_ACTION_DROP));
+    if (m_pmtPid != 0) {
+        std::fill(m_pidActions + 1, m_pidActions + 0x0030, static_cast<uint8_t>(PID_ACTION_PASS));
+        if (m_nitPid >= 0x0030) {
+            m_pidActions[m_nitPid] = PID_ACTION_NIT;
+        }
+        // In reverse order of precedence
+        const int routes[][2] = {
+            {m_superimposePid, PID_ACTION_SUPERIMPOSE},
+            {m_captionPid, PID_ACTION_CAPTION},
+            {m_audio2Pid, PID_ACTION_AUDIO2},
+            {m_audio1Pid, PID_ACTION_AUDIO1},
+            {m_videoPid, PID_ACTION_VIDEO},
+        };
+        for (size_t i = 0; i < sizeof(routes) / sizeof(routes[0]); ++i) {
+            if (routes[i][0] != 0) {
+                m_pidActions[routes[i][0]] = static_cast<uint8_t>(routes[i][1]);
+            }
+        }
+        m_pidActions[m_pmtPid] |= PID_ACTION_PMT;
+        m_pidActions[m_pcrPid] |= PID_ACTION_PCR;
+    }
+    // Always PAT
+    m_pidActions[0] = PID_ACTION_PAT;
+}
+
+void CServiceFilter::AddLastPmtPackets()
+{
+    for (size_t i = 0; i < m_lastPmtPackets.size(); i += 188) {
+        uint8_t *packet = m_packets.AddSlot();
+        std::copy(m_lastPmtPackets.begin() + i, m_lastPmtPackets.begin() + i + 188, packet);
         m_pmtCounter = (m_pmtCounter + 1) & 0x0f;
-        m_packets.push_back(0x10 | m_pmtCounter);
-        m_packets.insert(m_packets.end(), m_buf.begin() + i, m_buf.begin() + std::min(i + 184, m_buf.size()));
-        m_packets.resize(((m_packets.size() - 1) / 188 + 1) * 188, 0xff);
+        packet[3] = 0x10 | m_pmtCounter;
     }
 }
 
 void CServiceFilter::AddPcrAdaptation(const uint8_t *pcr)
 {
     // Create TS packet
-    m_packets.push_back(0x47);
+    uint8_t *packet = m_packets.AddSlot();
+    packet[0] = 0x47;
     // PCR_PID=0x01ff
-    m_packets.push_back(0x01);
-    m_packets.push_back(0xff);
-    m_packets.push_back(0x20);
-    m_packets.push_back(183);
-    m_packets.push_back(0x10);
-    m_packets.insert(m_packets.end(), pcr, pcr + 4);
+    packet[1] = 0x01;
+    packet[2] = 0xff;
+    packet[3] = 0x20;
+    packet[4] = 183;
+    packet[5] = 0x10;
+    std::copy(pcr, pcr + 4, packet + 6);
     // pcr_extension=0
-    m_packets.push_back((pcr[4] & 0x80) | 0x7e);
-    m_packets.push_back(0);
-    m_packets.resize((m_packets.size() / 188 + 1) * 188, 0xff);
+    packet[10] = (pcr[4] & 0x80) | 0x7e;
+    packet[11] = 0;
+    std::fill(packet + 12, packet + 188, 0xff);
 }
 
 void CServiceFilter::ChangePidAndAddPacket(const uint8_t *packet, int pid, uint8_t counter)
 {
-    m_packets.push_back(0x47);
-    m_packets.push_back((packet[1] & 0xe0) | static_cast<uint8_t>(pid >> 8));
-    m_packets.push_back(static_cast<uint8_t>(pid));
-    m_packets.push_back(counter > 0x0f ? packet[3] : ((packet[3] & 0xf0) | counter));
-    m_packets.insert(m_packets.end(), packet + 4, packet + 188);
+    uint8_t *dest = m_packets.AddSlot();
+    dest[0] = 0x47;
+    dest[1] = (packet[1] & 0xe0) | static_cast<uint8_t>(pid >> 8);
+    dest[2] = static_cast<uint8_t>(pid);
+    dest[3] = counter > 0x0f ? packet[3] : ((packet[3] & 0xf0) | counter);
+    std::copy(packet + 4, packet + 188, dest + 4);
 }
 
-void CServiceFilter::AddCaptionManagementPesPacket(int64_t pts, uint8_t counter)
+void CServiceFilter::ChangePidAndAddInputPacket(const uint8_t *packet, int pid, uint8_t counter)
 {
+    if (extract_ts_header_pid(packet) == pid && (counter > 0x0f || extract_ts_header_counter(packet) == counter)) {
+        // Unchanged, just refer to the input
+        m_packets.AddRef(packet);
+    }
+    else {
+        ChangePidAndAddPacket(packet, pid, counter);
+    }
+}
+
+void CServiceFilter::CreatePacketTemplates()
+{
+    static const uint8_t ADTS_2CH_48KHZ_SILENT[13] = {
+        0xff, 0xf1, 0x4c, 0x80, 0x01, 0xbf, 0xfc, 0x21, 0x10, 0x04, 0x60, 0x8c, 0x1c
+    };
     static const uint8_t SYNCHRONOUS_PES_JPN_MANAGEMENT[20] = {
         0x80, 0xff, 0xf0, 0x80, 0x00, 0x00, 0x00, 0x0a,
         0x3f, 0x01, 0x1a, 0x6a, 0x70, 0x6e, 0x80, 0x00, 0x00, 0x00,
         0xe4, 0x6a
     };
-    m_packets.push_back(0x47);
-    // PID=0x0130
-    m_packets.push_back(0x41);
-    m_packets.push_back(0x30);
-    m_packets.push_back(0x30 | counter);
-    m_packets.push_back(188 - 5 - (6 + 28));
-    m_packets.push_back(0x00);
-    // stuffing
-    m_packets.resize(m_packets.size() + 188 - 6 - (6 + 28), 0xff);
-    // PES
-    m_packets.push_back(0);
-    m_packets.push_back(0);
-    m_packets.push_back(1);
-    m_packets.push_back(0xbd);
-    m_packets.push_back(0);
-    m_packets.push_back(28);
-    m_packets.push_back(0x80);
-    // has PTS
-    m_packets.push_back(0x80);
-    m_packets.push_back(5);
-    m_packets.push_back(static_cast<uint8_t>(pts >> 29) | 0x21); // 3 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 22)); // 8 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 14) | 1); // 7 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 7)); // 8 bits
-    m_packets.push_back(static_cast<uint8_t>(pts << 1) | 1); // 7 bits
-    m_packets.insert(m_packets.end(), SYNCHRONOUS_PES_JPN_MANAGEMENT, SYNCHRONOUS_PES_JPN_MANAGEMENT + 20);
-}
-
-void CServiceFilter::AddSuperimposeManagementPesPacket(uint8_t counter)
-{
     static const uint8_t ASYNCHRONOUS_PES_JPN_MANAGEMENT[20] = {
         0x81, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x0a,
         0x3f, 0x01, 0x12, 0x6a, 0x70, 0x6e, 0x80, 0x00, 0x00, 0x00,
         0xae, 0xa2
     };
-    m_packets.push_back(0x47);
+
+    for (uint8_t index = 0; index < 2; ++index) {
+        uint8_t *packet = m_silentAudioPackets[index];
+        packet[0] = 0x47;
+        // PID=0x0110+index
+        packet[1] = 0x41;
+        packet[2] = 0x10 | index;
+        packet[3] = 0x30;
+        packet[4] = 188 - 5 - (6 + 8 + 13 * 3);
+        packet[5] = 0x40;
+        // stuffing
+        std::fill(packet + 6, packet + 188 - (6 + 8 + 13 * 3), 0xff);
+        // PES
+        uint8_t *pes = packet + 188 - (6 + 8 + 13 * 3);
+        pes[0] = 0;
+        pes[1] = 0;
+        pes[2] = 1;
+        pes[3] = 0xc0 | index;
+        pes[4] = 0;
+        pes[5] = 8 + 13 * 3;
+        // alignment by audio sync word
+        pes[6] = 0x84;
+        // has PTS
+        pes[7] = 0x80;
+        pes[8] = 5;
+        WritePesPts(pes + 9, 0);
+        // 1024samples(1frame) / 48000hz * 3 = 0.064sec
+        for (int i = 0; i < 3; ++i) {
+            std::copy(ADTS_2CH_48KHZ_SILENT, ADTS_2CH_48KHZ_SILENT + 13, pes + 14 + 13 * i);
+        }
+    }
+
+    uint8_t *packet = m_captionManagementPacket;
+    packet[0] = 0x47;
+    // PID=0x0130
+    packet[1] = 0x41;
+    packet[2] = 0x30;
+    packet[3] = 0x30;
+    packet[4] = 188 - 5 - (6 + 28);
+    packet[5] = 0x00;
+    // stuffing
+    std::fill(packet + 6, packet + 188 - (6 + 28), 0xff);
+    // PES
+    uint8_t *pes = packet + 188 - (6 + 28);
+    pes[0] = 0;
+    pes[1] = 0;
+    pes[2] = 1;
+    pes[3] = 0xbd;
+    pes[4] = 0;
+    pes[5] = 28;
+    pes[6] = 0x80;
+    // has PTS
+    pes[7] = 0x80;
+    pes[8] = 5;
+    WritePesPts(pes + 9, 0);
+    std::copy(SYNCHRONOUS_PES_JPN_MANAGEMENT, SYNCHRONOUS_PES_JPN_MANAGEMENT + 20, pes + 14);
+
+    packet = m_superimposeManagementPacket;
+    packet[0] = 0x47;
     // PID=0x0138
-    m_packets.push_back(0x41);
-    m_packets.push_back(0x38);
-    m_packets.push_back(0x30 | counter);
-    m_packets.push_back(188 - 5 - (6 + 20));
-    m_packets.push_back(0x00);
+    packet[1] = 0x41;
+    packet[2] = 0x38;
+    packet[3] = 0x30;
+    packet[4] = 188 - 5 - (6 + 20);
+    packet[5] = 0x00;
     // stuffing
-    m_packets.resize(m_packets.size() + 188 - 6 - (6 + 20), 0xff);
+    std::fill(packet + 6, packet + 188 - (6 + 20), 0xff);
     // PES
-    m_packets.push_back(0);
-    m_packets.push_back(0);
-    m_packets.push_back(1);
-    m_packets.push_back(0xbf);
-    m_packets.push_back(0);
-    m_packets.push_back(20);
-    m_packets.insert(m_packets.end(), ASYNCHRONOUS_PES_JPN_MANAGEMENT, ASYNCHRONOUS_PES_JPN_MANAGEMENT + 20);
+    pes = packet + 188 - (6 + 20);
+    pes[0] = 0;
+    pes[1] = 0;
+    pes[2] = 1;
+    pes[3] = 0xbf;
+    pes[4] = 0;
+    pes[5] = 20;
+    std::copy(ASYNCHRONOUS_PES_JPN_MANAGEMENT, ASYNCHRONOUS_PES_JPN_MANAGEMENT + 20, pes + 6);
+}
+
+void CServiceFilter::WritePesPts(uint8_t *dest, int64_t pts)
+{
+    dest[0] = static_cast<uint8_t>(pts >> 29) | 0x21; // 3 bits
+    dest[1] = static_cast<uint8_t>(pts >> 22); // 8 bits
+    dest[2] = static_cast<uint8_t>(pts >> 14) | 1; // 7 bits
+    dest[3] = static_cast<uint8_t>(pts >> 7); // 8 bits
+    dest[4] = static_cast<uint8_t>(pts << 1) | 1; // 7 bits
+}
+
+void CServiceFilter::AddCaptionManagementPesPacket(int64_t pts, uint8_t counter)
+{
+    uint8_t *packet = m_packets.AddSlot();
+    std::copy(m_captionManagementPacket, m_captionManagementPacket + 188, packet);
+    packet[3] = 0x30 | counter;
+    WritePesPts(packet + 188 - (6 + 28) + 9, pts);
+}
+
+void CServiceFilter::AddSuperimposeManagementPesPacket(uint8_t counter)
+{
+    uint8_t *packet = m_packets.AddSlot();
+    std::copy(m_superimposeManagementPacket, m_superimposeManagementPacket + 188, packet);
+    packet[3] = 0x30 | counter;
 }
 
 void CServiceFilter::AddAudioPesPackets(uint8_t index, int64_t targetPts, int64_t &pts, uint8_t &counter)
@@ -740,40 +896,11 @@ void CServiceFilter::AddAudioPesPackets(uint8_t index, int64_t targetPts, int64_
 
 void CServiceFilter::Add64MsecAudioPesPacket(uint8_t index, int64_t pts, uint8_t &counter)
 {
-    static const uint8_t ADTS_2CH_48KHZ_SILENT[13] = {
-        0xff, 0xf1, 0x4c, 0x80, 0x01, 0xbf, 0xfc, 0x21, 0x10, 0x04, 0x60, 0x8c, 0x1c
-    };
-    m_packets.push_back(0x47);
-    // PID=0x0110+index
-    m_packets.push_back(0x41);
-    m_packets.push_back(0x10 | index);
+    uint8_t *packet = m_packets.AddSlot();
+    std::copy(m_silentAudioPackets[index], m_silentAudioPackets[index] + 188, packet);
     counter = (counter + 1) & 0x0f;
-    m_packets.push_back(0x30 | counter);
-    m_packets.push_back(188 - 5 - (6 + 8 + 13 * 3));
-    m_packets.push_back(0x40);
-    // stuffing
-    m_packets.resize(m_packets.size() + 188 - 6 - (6 + 8 + 13 * 3), 0xff);
-    // PES
-    m_packets.push_back(0);
-    m_packets.push_back(0);
-    m_packets.push_back(1);
-    m_packets.push_back(0xc0 | index);
-    m_packets.push_back(0);
-    m_packets.push_back(8 + 13 * 3);
-    // alignment by audio sync word
-    m_packets.push_back(0x84);
-    // has PTS
-    m_packets.push_back(0x80);
-    m_packets.push_back(5);
-    m_packets.push_back(static_cast<uint8_t>(pts >> 29) | 0x21); // 3 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 22)); // 8 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 14) | 1); // 7 bits
-    m_packets.push_back(static_cast<uint8_t>(pts >> 7)); // 8 bits
-    m_packets.push_back(static_cast<uint8_t>(pts << 1) | 1); // 7 bits
-    // 1024samples(1frame) / 48000hz * 3 = 0.064sec
-    for (int i = 0; i < 3; ++i) {
-        m_packets.insert(m_packets.end(), ADTS_2CH_48KHZ_SILENT, ADTS_2CH_48KHZ_SILENT + 13);
-    }
+    packet[3] = 0x30 | counter;
+    WritePesPts(packet + 188 - (6 + 8 + 13 * 3) + 9, pts);
 }
 
 int64_t CServiceFilter::GetAudioPresentationTimeStamp(int unitStart, const uint8_t *payload, int payloadSize)
@@ -862,29 +989,30 @@ void CServiceFilter::ConcatenatePayload(std::vector<uint8_t> &dest, const std::v
 void CServiceFilter::AddAudioPesPackets(const std::vector<uint8_t> &pes, int pid, uint8_t &counter, int64_t &ptsPcrDiff, const uint8_t *pcr)
 {
     for (size_t i = 0; i < pes.size(); ) {
-        m_packets.push_back(0x47);
-        m_packets.push_back((i == 0 ? 0x40 : 0) | static_cast<uint8_t>(pid >> 8));
-        m_packets.push_back(static_cast<uint8_t>(pid));
+        uint8_t *packet = m_packets.AddSlot();
+        packet[0] = 0x47;
+        packet[1] = (i == 0 ? 0x40 : 0) | static_cast<uint8_t>(pid >> 8);
+        packet[2] = static_cast<uint8_t>(pid);
         counter = (counter + 1) & 0x0f;
         size_t len = std::min<size_t>(184, pes.size() - i);
         if (pcr && i + len >= pes.size() && len > 176) {
             // Reduce payload in order to insert PCR
             len = 176;
         }
-        m_packets.push_back((len < 184 ? 0x30 : 0x10) | counter);
+        packet[3] = (len < 184 ? 0x30 : 0x10) | counter;
         if (len < 184) {
-            m_packets.push_back(static_cast<uint8_t>(183 - len));
+            packet[4] = static_cast<uint8_t>(183 - len);
             if (len < 183) {
                 if (pcr && len <= 176) {
                     // Insert PCR
-                    m_packets.push_back(0x10);
-                    m_packets.insert(m_packets.end(), pcr, pcr + 6);
-                    m_packets.insert(m_packets.end(), 176 - len, 0xff);
+                    packet[5] = 0x10;
+                    std::copy(pcr, pcr + 6, packet + 6);
+                    std::fill(packet + 12, packet + 188 - len, 0xff);
                     pcr = nullptr;
                 }
                 else {
-                    m_packets.push_back(0x00);
-                    m_packets.insert(m_packets.end(), 182 - len, 0xff);
+                    packet[5] = 0x00;
+                    std::fill(packet + 6, packet + 188 - len, 0xff);
                 }
             }
         }
@@ -892,7 +1020,7 @@ void CServiceFilter::AddAudioPesPackets(const std::vector<uint8_t> &pes, int pid
         if (pts >= 0 && m_pcr >= 0) {
             ptsPcrDiff = 0x200000000 + pts - m_pcr;
         }
-        m_packets.insert(m_packets.end(), pes.begin() + i, pes.begin() + i + len);
+        std::copy(pes.begin() + i, pes.begin() + i + len, packet + 188 - len);
         i += len;
     }
 }
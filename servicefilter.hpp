@@ -1,6 +1,7 @@
 #ifndef INCLUDE_SERVICEFILTER_HPP
 #define INCLUDE_SERVICEFILTER_HPP
 
+#include "streammodel.hpp"
 #include "util.hpp"
 #include <stdint.h>
 #include <vector>
@@ -10,13 +11,17 @@ class CServiceFilter
 public:
     CServiceFilter();
     void SetProgramNumberOrIndex(int n) { m_programNumberOrIndex = n; }
+    int GetProgramNumberOrIndex() const { return m_programNumberOrIndex; }
     void SetAudio1Mode(int mode);
     void SetAudio2Mode(int mode);
     void SetCaptionMode(int mode);
     void SetSuperimposeMode(int mode);
-    void AddPacket(const uint8_t *packet);
-    const std::vector<uint8_t> &GetPackets() const { return m_packets; }
-    void ClearPackets() { m_packets.clear(); }
+    // Shares "model" updated with each packet before AddPacket(), instead of modeling the packets internally.
+    void SetStreamModel(const CStreamModel *model) { m_sharedModel = model; }
+    // Adds the "index"-th packet of the decoded batch.
+    void AddPacket(const TS_HEADERS &headers, size_t index);
+    const CPacketList &GetPackets() const { return m_packets; }
+    void ClearPackets() { m_packets.Clear(); }
 
 private:
     const uint8_t H_262_VIDEO = 0x02;
@@ -26,12 +31,35 @@ private:
     const uint8_t AVC_VIDEO = 0x1b;
     const uint8_t H_265_VIDEO = 0x24;
 
+    // What AddPacket() does with the packets of each PID. A route combined with PID_ACTION_PMT and PID_ACTION_PCR.
+    enum
+    {
+        PID_ACTION_DROP,
+        PID_ACTION_PAT,
+        PID_ACTION_PASS,
+        PID_ACTION_NIT,
+        PID_ACTION_VIDEO,
+        PID_ACTION_AUDIO1,
+        PID_ACTION_AUDIO2,
+        PID_ACTION_CAPTION,
+        PID_ACTION_SUPERIMPOSE,
+        PID_ACTION_ROUTE_MASK = 0x0f,
+        PID_ACTION_PMT = 0x10,
+        PID_ACTION_PCR = 0x20,
+    };
+
+    const CStreamModel &GetModel() const { return m_sharedModel ? *m_sharedModel : m_model; }
     static std::vector<PMT_REF>::const_iterator FindNitRef(const std::vector<PMT_REF> &pmt);
     std::vector<PMT_REF>::const_iterator FindTargetPmtRef(const std::vector<PMT_REF> &pmt) const;
     void AddPat(int transportStreamID, int programNumber, bool addNit);
     void AddPmt(const PSI &psi);
+    void UpdatePidActions();
+    void AddLastPmtPackets();
     void AddPcrAdaptation(const uint8_t *pcr);
     void ChangePidAndAddPacket(const uint8_t *packet, int pid, uint8_t counter = 0xff);
+    void ChangePidAndAddInputPacket(const uint8_t *packet, int pid, uint8_t counter = 0xff);
+    void CreatePacketTemplates();
+    static void WritePesPts(uint8_t *dest, int64_t pts);
     void AddAudioPesPackets(uint8_t index, int64_t targetPts, int64_t &pts, uint8_t &counter);
     void Add64MsecAudioPesPacket(uint8_t index, int64_t pts, uint8_t &counter);
     static int64_t GetAudioPresentationTimeStamp(int unitStart, const uint8_t *payload, int payloadSize);
@@ -54,9 +82,14 @@ private:
     int m_superimposeMode;
     bool m_captionInsertManagementPacket;
     bool m_superimposeInsertManagementPacket;
-    std::vector<uint8_t> m_packets;
-    PAT m_pat;
+    CPacketList m_packets;
+    CStreamModel m_model;
+    const CStreamModel *m_sharedModel;
     PSI m_pmtPsi;
+    // PIDs of the target PMT and the NIT in the PAT, or 0 if not found
+    int m_pmtPid;
+    int m_nitPid;
+    uint8_t m_pidActions[8192];
     int m_videoPid;
     int m_audio1Pid;
     int m_audio2Pid;
@@ -89,6 +122,18 @@ private:
     std::vector<uint8_t> m_destRightBuf;
     std::vector<uint8_t> m_lastPat;
     std::vector<uint8_t> m_lastPmt;
+    // Synthesized packets created in advance, of which only the counters (and PTS) are set when added
+    int m_patTransportStreamID;
+    int m_patProgramNumber;
+    bool m_patAddNit;
+    uint8_t m_patPacket[188];
+    std::vector<uint8_t> m_lastPmtPackets;
+    uint8_t m_silentAudioPackets[2][188];
+    uint8_t m_captionManagementPacket[188];
+    uint8_t m_superimposeManagementPacket[188];
+    // Whether m_lastPmt is created from m_pmtPsi under the current state
+    bool m_lastPmtReusable;
+    bool m_lastPmtDualMono;
 };
 
 #endif
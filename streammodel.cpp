@@ -0,0 +1,61 @@
+#include "streammodel.hpp"
+#include <algorithm>
+
+CStreamModel::CStreamModel()
+    : m_firstPmtPid(0)
+    , m_pcrPid(0)
+    , m_pcr(-1)
+    , m_firstPcr(false)
+    , m_pcrOnPmtPid(false)
+{
+    m_pat = PAT();
+    m_firstPmtPsi = PSI();
+}
+
+void CStreamModel::AddPacket(const TS_HEADERS &headers, size_t index)
+{
+    const uint8_t *packet = headers.packet[index];
+    int unitStart = headers.unit_start[index];
+    int pid = headers.pid[index];
+    int counter = headers.counter[index];
+    int payloadSize = 188 - headers.payload_offset[index];
+    const uint8_t *payload = packet + headers.payload_offset[index];
+
+    m_pmtSections.clear();
+    m_firstPcr = false;
+
+    if (pid == 0) {
+        extract_pat(&m_pat, payload, payloadSize, unitStart, counter);
+        auto itFirstPmt = std::find_if(m_pat.pmt.begin(), m_pat.pmt.end(), [](const PMT_REF &pmt) { return pmt.program_number != 0; });
+        if (m_firstPmtPid != 0 && (itFirstPmt == m_pat.pmt.end() || itFirstPmt->pmt_pid != m_firstPmtPid)) {
+            m_firstPmtPid = 0;
+            m_firstPmtPsi = PSI();
+        }
+        if (itFirstPmt != m_pat.pmt.end()) {
+            m_firstPmtPid = itFirstPmt->pmt_pid;
+        }
+    }
+    else {
+        if (pid == m_firstPmtPid) {
+            int done;
+            do {
+                done = extract_psi(&m_firstPmtPsi, payload, payloadSize, unitStart, counter);
+                if (m_firstPmtPsi.version_number) {
+                    m_pmtSections.push_back(m_firstPmtPsi);
+                    if (m_firstPmtPsi.table_id == 2 && m_firstPmtPsi.section_length >= 9) {
+                        const uint8_t *table = m_firstPmtPsi.data;
+                        m_pcrPid = ((table[8] & 0x1f) << 8) | table[9];
+                        if (m_pcrPid == 0x1fff) {
+                            m_pcr = -1;
+                        }
+                    }
+                }
+            }
+            while (!done);
+        }
+        if (pid == m_pcrPid && headers.pcr_flag[index] && (pid != m_firstPmtPid || m_pcrOnPmtPid)) {
+            m_firstPcr = m_pcr < 0;
+            m_pcr = extract_ts_pcr(packet);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef INCLUDE_STREAMMODEL_HPP
+#define INCLUDE_STREAMMODEL_HPP
+
+#include "util.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Tracks the PAT, the PMT of the first service and the PCR of a stream once per packet, for the stages sharing the stream.
+class CStreamModel
+{
+public:
+    CStreamModel();
+    // Updates the model with the "index"-th packet of the decoded batch. Call this before passing the packet to the stages.
+    void AddPacket(const TS_HEADERS &headers, size_t index);
+    // Accepts the PCR carried by the PMT PID of the first service, which is ignored by default.
+    void SetPcrOnPmtPid(bool enabled) { m_pcrOnPmtPid = enabled; }
+    const PAT &GetPat() const { return m_pat; }
+    int GetFirstPmtPid() const { return m_firstPmtPid; }
+    // Valid PMT sections of the first service extracted from the last packet, usually none.
+    const std::vector<PSI> &GetPmtSections() const { return m_pmtSections; }
+    int GetPcrPid() const { return m_pcrPid; }
+    // Returns the last PCR, or -1 if not determined.
+    int64_t GetPcr() const { return m_pcr; }
+    // Returns true if the last packet carried the first PCR since the PCR became undetermined.
+    bool IsFirstPcr() const { return m_firstPcr; }
+
+private:
+    PAT m_pat;
+    int m_firstPmtPid;
+    PSI m_firstPmtPsi;
+    std::vector<PSI> m_pmtSections;
+    int m_pcrPid;
+    int64_t m_pcr;
+    bool m_firstPcr;
+    bool m_pcrOnPmtPid;
+};
+
+#endif
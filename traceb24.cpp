@@ -3,70 +3,43 @@
 
 CTraceB24Caption::CTraceB24Caption()
     : m_fp(nullptr)
-    , m_firstPmtPid(0)
+    , m_sharedModel(nullptr)
     , m_captionPid(0)
     , m_superimposePid(0)
-    , m_pcrPid(0)
-    , m_pcr(-1)
 {
-    static const PAT zeroPat = {};
-    m_pat = zeroPat;
-    m_firstPmtPsi = zeroPat.psi;
 }
 
-void CTraceB24Caption::AddPacket(const uint8_t *packet)
+void CTraceB24Caption::AddPacket(const TS_HEADERS &headers, size_t index)
 {
+    const uint8_t *packet = headers.packet[index];
     if (!m_fp) {
         return;
     }
+    if (!m_sharedModel) {
+        m_model.AddPacket(headers, index);
+    }
 
-    int unitStart = extract_ts_header_unit_start(packet);
-    int pid = extract_ts_header_pid(packet);
-    int adaptation = extract_ts_header_adaptation(packet);
-    int counter = extract_ts_header_counter(packet);
-    int payloadSize = get_ts_payload_size(packet);
-    const uint8_t *payload = packet + 188 - payloadSize;
+    int unitStart = headers.unit_start[index];
+    int pid = headers.pid[index];
+    int counter = headers.counter[index];
+    int payloadSize = 188 - headers.payload_offset[index];
+    const uint8_t *payload = packet + headers.payload_offset[index];
 
-    if (pid == 0) {
-        extract_pat(&m_pat, payload, payloadSize, unitStart, counter);
-        auto itFirstPmt = std::find_if(m_pat.pmt.begin(), m_pat.pmt.end(), [](const PMT_REF &pmt) { return pmt.program_number != 0; });
-        if (m_firstPmtPid != 0 && (itFirstPmt == m_pat.pmt.end() || itFirstPmt->pmt_pid != m_firstPmtPid)) {
-            m_firstPmtPid = 0;
-            static const PSI zeroPsi = {};
-            m_firstPmtPsi = zeroPsi;
-        }
-        if (itFirstPmt != m_pat.pmt.end()) {
-            m_firstPmtPid = itFirstPmt->pmt_pid;
-        }
-    }
-    else if (pid == m_firstPmtPid) {
-        int done;
-        do {
-            done = extract_psi(&m_firstPmtPsi, payload, payloadSize, unitStart, counter);
-            if (m_firstPmtPsi.version_number && m_firstPmtPsi.table_id == 2) {
-                CheckPmt(m_firstPmtPsi);
+    if (pid == GetModel().GetFirstPmtPid()) {
+        const std::vector<PSI> &sections = GetModel().GetPmtSections();
+        for (auto it = sections.begin(); it != sections.end(); ++it) {
+            if (it->table_id == 2) {
+                CheckPmt(*it);
             }
         }
-        while (!done);
     }
-    else if (pid == m_pcrPid) {
-        if (adaptation & 2) {
-            int adaptationLength = packet[4];
-            if (adaptationLength >= 6 && !!(packet[5] & 0x10)) {
-                bool firstPcr = m_pcr < 0;
-                m_pcr = (packet[10] >> 7) |
-                        (packet[9] << 1) |
-                        (packet[8] << 9) |
-                        (packet[7] << 17) |
-                        (static_cast<int64_t>(packet[6]) << 25);
-                if (firstPcr) {
-                    fprintf(m_fp, "pcrpid=0x%04X;pcr=%010lld\n", m_pcrPid, static_cast<long long>(m_pcr));
-                    fflush(m_fp);
-                }
-            }
+    else if (pid == GetModel().GetPcrPid()) {
+        if (GetModel().IsFirstPcr()) {
+            fprintf(m_fp, "pcrpid=0x%04X;pcr=%010lld\n", GetModel().GetPcrPid(), static_cast<long long>(GetModel().GetPcr()));
+            fflush(m_fp);
         }
     }
-    else if (pid == m_captionPid || pid == m_superimposePid) {
+    else if (pid != 0 && (pid == m_captionPid || pid == m_superimposePid)) {
         auto &pesPair = pid == m_captionPid ? m_captionPes : m_superimposePes;
         int &pesCounter = pesPair.first;
         std::vector<uint8_t> &pes = pesPair.second;
@@ -104,11 +77,11 @@ void CTraceB24Caption::CheckPmt(const PSI &psi)
     if (psi.section_length < 9) {
         return;
     }
-    const uint8_t *table = psi.data;
-    m_pcrPid = ((table[8] & 0x1f) << 8) | table[9];
-    if (m_pcrPid == 0x1fff) {
-        m_pcr = -1;
+    if (psi.unchanged) {
+        // The caption PIDs are the same as the last time
+        return;
     }
+    const uint8_t *table = psi.data;
     int programInfoLength = ((table[10] & 0x03) << 8) | table[11];
     int pos = 3 + 9 + programInfoLength;
     if (psi.section_length < pos) {
@@ -182,8 +155,8 @@ void CTraceB24Caption::OutputPrivateDataPes(const std::vector<uint8_t> &pes,
         }
         else if (streamID == PRIVATE_STREAM_2) {
             payloadPos = 6;
-            if (m_pcr >= 0) {
-                pts = m_pcr;
+            if (GetModel().GetPcr() >= 0) {
+                pts = GetModel().GetPcr();
             }
         }
     }
@@ -200,13 +173,14 @@ void CTraceB24Caption::OutputPrivateDataPes(const std::vector<uint8_t> &pes,
 
     PARSE_PRIVATE_DATA_RESULT ret = ParsePrivateData(m_buf, m_intBuf, pes.data() + payloadPos, pes.size() - payloadPos, drcsList, langTags);
     if (ret != PARSE_PRIVATE_DATA_FAILED_NEED_MANAGEMENT) {
-        int64_t ptsPcrDiff = (0x200000000 + pts - m_pcr) & 0x1ffffffff;
+        int64_t pcr = GetModel().GetPcr();
+        int64_t ptsPcrDiff = (0x200000000 + pts - pcr) & 0x1ffffffff;
         if (ptsPcrDiff >= 0x100000000) {
             ptsPcrDiff -= 0x200000000;
         }
         fprintf(m_fp, "pts=%010lld;pcrrel=%+08d",
                 static_cast<long long>(pts),
-                static_cast<int>(m_pcr < 0 ? -9999999 : std::min<int64_t>(std::max<int64_t>(ptsPcrDiff, -9999999), 9999999)));
+                static_cast<int>(pcr < 0 ? -9999999 : std::min<int64_t>(std::max<int64_t>(ptsPcrDiff, -9999999), 9999999)));
         if (ret == PARSE_PRIVATE_DATA_SUCCEEDED) {
             for (size_t i = 0; i + 1 < m_intBuf.size(); ++i) {
                 fprintf(m_fp, "%s%d", i == 0 ? ";text=" : ",", m_intBuf[i + 1] - m_intBuf[i]);
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_TRACEB24_HPP
 #define INCLUDE_TRACEB24_HPP
 
+#include "streammodel.hpp"
 #include "util.hpp"
 #include <stdint.h>
 #include <stdio.h>
@@ -11,10 +12,14 @@ class CTraceB24Caption
 {
 public:
     CTraceB24Caption();
-    void AddPacket(const uint8_t *packet);
+    void AddPacket(const TS_HEADERS &headers, size_t index);
     void SetFile(FILE *fp) { m_fp = fp; }
+    // Shares "model" updated with each packet before AddPacket(), instead of modeling the packets internally.
+    void SetStreamModel(const CStreamModel *model) { m_sharedModel = model; }
 
 private:
+    const CStreamModel &GetModel() const { return m_sharedModel ? *m_sharedModel : m_model; }
+
     enum LANG_TAG_TYPE
     {
         LANG_TAG_ABSENT,
@@ -40,9 +45,8 @@ private:
                                                       std::vector<uint16_t> &drcsList, LANG_TAG_TYPE (&langTags)[8]);
 
     FILE *m_fp;
-    PAT m_pat;
-    int m_firstPmtPid;
-    PSI m_firstPmtPsi;
+    CStreamModel m_model;
+    const CStreamModel *m_sharedModel;
     int m_captionPid;
     int m_superimposePid;
     std::pair<int, std::vector<uint8_t>> m_captionPes;
@@ -51,8 +55,6 @@ private:
     std::vector<uint16_t> m_superimposeDrcsList;
     LANG_TAG_TYPE m_captionLangTags[8];
     LANG_TAG_TYPE m_superimposeLangTags[8];
-    int m_pcrPid;
-    int64_t m_pcr;
     std::vector<uint8_t> m_buf;
     std::vector<int> m_intBuf;
 };
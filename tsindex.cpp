@@ -0,0 +1,255 @@
+#include "tsindex.hpp"
+#include <algorithm>
+
+namespace
+{
+const int PCR_SAMPLE_INTERVAL_SEC = 1;
+const int RANDOM_ACCESS_MAX_DISTANCE_SEC = 5;
+const uint8_t INDEX_MAGIC[8] = {'T', 'S', 'R', 'X', 'I', 'D', 'X', '1'};
+const size_t INDEX_HEADER_SIZE = 24;
+const size_t INDEX_RECORD_SIZE = 16;
+
+void WriteLE(uint8_t *dest, int64_t value, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        dest[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+int64_t ReadLE(const uint8_t *src, int size)
+{
+    int64_t value = 0;
+    for (int i = 0; i < size; ++i) {
+        value |= static_cast<int64_t>(src[i]) << (i * 8);
+    }
+    return value;
+}
+}
+
+CTsIndex::CTsIndex()
+    : m_patVersion(0)
+    , m_patUnitStartOffset(0)
+    , m_pcrPid(0)
+    , m_videoPid(0)
+    , m_pcr(-1)
+    , m_lastSamplePcr(-1)
+{
+    m_pat = PAT();
+}
+
+void CTsIndex::AddPacket(const TS_HEADERS &headers, size_t index, int64_t offset)
+{
+    const uint8_t *packet = headers.packet[index];
+    int unitStart = headers.unit_start[index];
+    int pid = headers.pid[index];
+    int adaptation = headers.adaptation[index];
+    int counter = headers.counter[index];
+    int payloadSize = 188 - headers.payload_offset[index];
+    const uint8_t *payload = packet + headers.payload_offset[index];
+
+    if (pid == 0) {
+        if (unitStart) {
+            m_patUnitStartOffset = offset;
+        }
+        extract_pat(&m_pat, payload, payloadSize, unitStart, counter);
+        if (m_pat.version_number && m_pat.version_number != m_patVersion) {
+            m_patVersion = m_pat.version_number;
+            RECORD rec = {m_patUnitStartOffset, RECORD_PAT, 0, m_patVersion & 0x1f};
+            m_records.push_back(rec);
+            // Follow the PMT list, keeping the states of existing PMTs
+            std::vector<PMT_STATE> pmts;
+            for (auto it = m_pat.pmt.begin(); it != m_pat.pmt.end(); ++it) {
+                if (it->program_number != 0) {
+                    auto itState = std::find_if(m_pmts.begin(), m_pmts.end(), [=](const PMT_STATE &s) { return s.pid == it->pmt_pid; });
+                    if (itState != m_pmts.end()) {
+                        pmts.push_back(*itState);
+                    }
+                    else {
+                        PMT_STATE s = {it->pmt_pid, PSI(), 0, -1};
+                        pmts.push_back(s);
+                    }
+                }
+            }
+            m_pmts.swap(pmts);
+        }
+    }
+    else {
+        for (auto it = m_pmts.begin(); it != m_pmts.end(); ++it) {
+            if (pid == it->pid) {
+                if (unitStart) {
+                    it->unitStartOffset = offset;
+                }
+                int done;
+                do {
+                    done = extract_psi(&it->psi, payload, payloadSize, unitStart, counter);
+                    if (it->psi.version_number && it->psi.table_id == 2 && it->psi.current_next_indicator &&
+                        it->psi.version_number != it->version && it->unitStartOffset >= 0) {
+                        it->version = it->psi.version_number;
+                        RECORD rec = {it->unitStartOffset, RECORD_PMT, pid, it->version & 0x1f};
+                        m_records.push_back(rec);
+                        if (it == m_pmts.begin()) {
+                            CheckPmt(it->psi);
+                        }
+                    }
+                }
+                while (!done);
+                break;
+            }
+        }
+    }
+
+    if (pid == m_pcrPid && headers.pcr_flag[index]) {
+        int64_t pcr = extract_ts_pcr(packet);
+        if (pcr >= 0) {
+            m_pcr = pcr;
+            // Discontinuities are also sampled since the difference wraps around
+            int64_t pcrDiff = (0x200000000 + pcr - m_lastSamplePcr) & 0x1ffffffff;
+            if (m_lastSamplePcr < 0 || pcrDiff >= 90000 * PCR_SAMPLE_INTERVAL_SEC) {
+                RECORD rec = {offset, RECORD_PCR, pid, pcr};
+                m_records.push_back(rec);
+                m_lastSamplePcr = pcr;
+            }
+        }
+    }
+    // random_access_indicator
+    if (pid == m_videoPid && (adaptation & 2) && packet[4] >= 1 && !!(packet[5] & 0x40) && m_pcr >= 0) {
+        RECORD rec = {offset, RECORD_RANDOM_ACCESS, pid, m_pcr};
+        m_records.push_back(rec);
+    }
+}
+
+void CTsIndex::CheckPmt(const PSI &psi)
+{
+    const uint8_t H_262_VIDEO = 0x02;
+    const uint8_t AVC_VIDEO = 0x1b;
+    const uint8_t H_265_VIDEO = 0x24;
+
+    if (psi.section_length < 9) {
+        return;
+    }
+    const uint8_t *table = psi.data;
+    int pcrPid = ((table[8] & 0x1f) << 8) | table[9];
+    if (pcrPid != m_pcrPid) {
+        m_pcrPid = pcrPid;
+        m_pcr = -1;
+        m_lastSamplePcr = -1;
+    }
+    int programInfoLength = ((table[10] & 0x03) << 8) | table[11];
+    int pos = 3 + 9 + programInfoLength;
+    if (psi.section_length < pos) {
+        return;
+    }
+
+    int videoPid = 0;
+    int tableLen = 3 + psi.section_length - 4/*CRC32*/;
+    while (pos + 4 < tableLen) {
+        int streamType = table[pos];
+        int esPid = ((table[pos + 1] & 0x1f) << 8) | table[pos + 2];
+        int esInfoLength = ((table[pos + 3] & 0x03) << 8) | table[pos + 4];
+        if (streamType == H_262_VIDEO || streamType == AVC_VIDEO || streamType == H_265_VIDEO) {
+            videoPid = esPid;
+            break;
+        }
+        pos += 5 + esInfoLength;
+    }
+    m_videoPid = videoPid;
+}
+
+bool CTsIndex::Save(FILE *fp, int64_t inputSize) const
+{
+    uint8_t buf[INDEX_HEADER_SIZE] = {};
+    std::copy(INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC), buf);
+    WriteLE(buf + 8, inputSize, 8);
+    WriteLE(buf + 16, m_records.size(), 4);
+    if (fwrite(buf, 1, INDEX_HEADER_SIZE, fp) != INDEX_HEADER_SIZE) {
+        return false;
+    }
+    for (auto it = m_records.begin(); it != m_records.end(); ++it) {
+        WriteLE(buf, it->offset, 8);
+        WriteLE(buf + 8, it->pid, 2);
+        buf[10] = static_cast<uint8_t>(it->type);
+        WriteLE(buf + 11, it->value, 5);
+        if (fwrite(buf, 1, INDEX_RECORD_SIZE, fp) != INDEX_RECORD_SIZE) {
+            return false;
+        }
+    }
+    return fflush(fp) == 0;
+}
+
+bool CTsIndex::Load(FILE *fp, int64_t inputSize)
+{
+    uint8_t buf[INDEX_HEADER_SIZE];
+    if (fread(buf, 1, INDEX_HEADER_SIZE, fp) != INDEX_HEADER_SIZE ||
+        !std::equal(INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC), buf) ||
+        ReadLE(buf + 8, 8) != inputSize) {
+        return false;
+    }
+    // The count is not trusted for allocation since the index may be truncated or corrupt
+    int64_t count = ReadLE(buf + 16, 4);
+    std::vector<RECORD> records;
+    for (int64_t i = 0; i < count; ++i) {
+        if (fread(buf, 1, INDEX_RECORD_SIZE, fp) != INDEX_RECORD_SIZE ||
+            buf[10] < RECORD_PCR || buf[10] > RECORD_PMT) {
+            return false;
+        }
+        RECORD rec;
+        rec.offset = ReadLE(buf, 8);
+        rec.pid = static_cast<int>(ReadLE(buf + 8, 2));
+        rec.type = static_cast<RECORD_TYPE>(buf[10]);
+        rec.value = ReadLE(buf + 11, 5);
+        records.push_back(rec);
+    }
+    if (fgetc(fp) != EOF) {
+        return false;
+    }
+    m_records.swap(records);
+    return true;
+}
+
+int64_t CTsIndex::FindSeekOffset(int seekSec, int &pcrPid, int64_t &targetPcr) const
+{
+    auto itFirst = std::find_if(m_records.begin(), m_records.end(), [](const RECORD &rec) { return rec.type == RECORD_PCR; });
+    if (itFirst == m_records.end()) {
+        return -1;
+    }
+    int64_t target = 90000LL * seekSec;
+    auto itSample = itFirst;
+    auto itRandomAccess = m_records.end();
+    for (auto it = itFirst; it != m_records.end(); ++it) {
+        if (it->type == RECORD_PCR || it->type == RECORD_RANDOM_ACCESS) {
+            int64_t elapsed = (0x200000000 + it->value - itFirst->value) & 0x1ffffffff;
+            if (elapsed > target) {
+                if (it->type == RECORD_PCR) {
+                    break;
+                }
+            }
+            else if (it->type == RECORD_PCR) {
+                itSample = it;
+            }
+            else if (target - elapsed <= 90000 * RANDOM_ACCESS_MAX_DISTANCE_SEC) {
+                itRandomAccess = it;
+            }
+        }
+    }
+    pcrPid = itFirst->pid;
+    targetPcr = (itFirst->value + target) & 0x1ffffffff;
+    // The random access point may be after the sample
+    return itRandomAccess != m_records.end() ? itRandomAccess->offset : itSample->offset;
+}
+
+std::vector<CTsIndex::RECORD> CTsIndex::GetPsiRecords(int64_t offset) const
+{
+    std::vector<RECORD> records;
+    for (auto it = m_records.begin(); it != m_records.end(); ++it) {
+        if ((it->type == RECORD_PAT || it->type == RECORD_PMT) && it->offset <= offset) {
+            auto itSame = std::find_if(records.begin(), records.end(), [=](const RECORD &rec) { return rec.pid == it->pid; });
+            if (itSame != records.end()) {
+                *itSame = *it;
+            }
+            else {
+                records.push_back(*it);
+            }
+        }
+    }
+    return records;
+}
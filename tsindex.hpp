@@ -0,0 +1,65 @@
+#ifndef INCLUDE_TSINDEX_HPP
+#define INCLUDE_TSINDEX_HPP
+
+#include "util.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Sidecar index of an input file, which records PCR samples, random access points of the video and changes of PAT/PMT
+// versions with their byte offsets.
+class CTsIndex
+{
+public:
+    enum RECORD_TYPE
+    {
+        RECORD_PCR = 1,
+        RECORD_RANDOM_ACCESS,
+        RECORD_PAT,
+        RECORD_PMT,
+    };
+
+    struct RECORD
+    {
+        int64_t offset;
+        RECORD_TYPE type;
+        int pid;
+        // PCR for RECORD_PCR and RECORD_RANDOM_ACCESS, version_number for the others
+        int64_t value;
+    };
+
+    CTsIndex();
+    // Adds the "index"-th packet of the decoded batch. "offset" is the byte offset of the packet in the input.
+    void AddPacket(const TS_HEADERS &headers, size_t index, int64_t offset);
+    bool Save(FILE *fp, int64_t inputSize) const;
+    // Fails if the index is not for the input of "inputSize" bytes.
+    bool Load(FILE *fp, int64_t inputSize);
+    // Returns the offset of the random access point (or PCR sample) at or before "seekSec" seconds from the first PCR,
+    // or -1 if not found. targetPcr is set to the PCR of the time to seek.
+    int64_t FindSeekOffset(int seekSec, int &pcrPid, int64_t &targetPcr) const;
+    // Returns the last PAT/PMT version changes at or before "offset".
+    std::vector<RECORD> GetPsiRecords(int64_t offset) const;
+
+private:
+    struct PMT_STATE
+    {
+        int pid;
+        PSI psi;
+        int version;
+        int64_t unitStartOffset;
+    };
+
+    void CheckPmt(const PSI &psi);
+
+    PAT m_pat;
+    int m_patVersion;
+    int64_t m_patUnitStartOffset;
+    std::vector<PMT_STATE> m_pmts;
+    int m_pcrPid;
+    int m_videoPid;
+    int64_t m_pcr;
+    int64_t m_lastSamplePcr;
+    std::vector<RECORD> m_records;
+};
+
+#endif
@@ -8,27 +8,57 @@
 #define _FILE_OFFSET_BITS 64
 #endif
 #include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#endif
 #include <sys/select.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
-#include <thread>
+#include <deque>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
 #endif
 #include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
-#include <unordered_set>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "id3conv.hpp"
+#include "pcrpacer.hpp"
 #include "servicefilter.hpp"
+#include "streammodel.hpp"
 #include "traceb24.hpp"
+#include "tsindex.hpp"
 #include "util.hpp"
 
 namespace
 {
+#ifdef _WIN32
+typedef wchar_t ARG_CHAR;
+#else
+typedef char ARG_CHAR;
+#endif
+const ARG_CHAR EMPTY_ARG[1] = {};
+
 void SleepFor(std::chrono::milliseconds rel)
 {
 #ifdef _WIN32
@@ -42,7 +72,7 @@ void SleepFor(std::chrono::milliseconds rel)
 #ifdef _WIN32
 const char *GetSmallString(const wchar_t *s)
 {
-    static char ss[32];
+    static thread_local char ss[32];
     size_t i = 0;
     for (; i < sizeof(ss) - 1 && s[i]; ++i) {
         ss[i] = 0 < s[i] && s[i] <= 127 ? static_cast<char>(s[i]) : '?';
@@ -58,111 +88,1597 @@ int64_t SeekFile(HANDLE file, int64_t offset)
     return SetFilePointerEx(file, li, &li, offset < 0 ? FILE_END : FILE_BEGIN) ? li.QuadPart : -1;
 }
 
-template<class P>
-int ReadFileToBuffer(HANDLE file, uint8_t *buf, size_t count, HANDLE asyncContext, P asyncCancelProc)
+// asyncRemainingProc returns the remaining time until the asynchronous reading is canceled
+template<class P>
+int ReadFileToBuffer(HANDLE file, uint8_t *buf, size_t count, HANDLE asyncContext, P asyncRemainingProc)
+{
+    OVERLAPPED ol = {};
+    DWORD nRead;
+    if (asyncContext) {
+        // For asynchronous, returns -1 for EOF
+        ol.hEvent = asyncContext;
+        if (ReadFile(file, buf, static_cast<DWORD>(count), nullptr, &ol)) {
+            return GetOverlappedResult(file, &ol, &nRead, FALSE) ? nRead : -1;
+        }
+        else if (GetLastError() == ERROR_IO_PENDING) {
+            for (;;) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(asyncRemainingProc());
+                if (remaining.count() <= 0) {
+                    break;
+                }
+                DWORD waitMsec = static_cast<DWORD>(std::min<int64_t>(remaining.count() + 1, 60000));
+                if (WaitForSingleObject(asyncContext, waitMsec) != WAIT_TIMEOUT) {
+                    return GetOverlappedResult(file, &ol, &nRead, FALSE) ? nRead : -1;
+                }
+            }
+            CancelIo(file);
+            WaitForSingleObject(asyncContext, INFINITE);
+            // The reading may have completed before canceled
+            if (GetOverlappedResult(file, &ol, &nRead, FALSE) && nRead > 0) {
+                return nRead;
+            }
+        }
+    }
+    else if (ReadFile(file, buf, static_cast<DWORD>(count), &nRead, nullptr)) {
+        // For synchronous, 0 means EOF
+        return nRead;
+    }
+    return -1;
+}
+
+void CloseFile(HANDLE file, HANDLE asyncContext)
+{
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+    if (asyncContext) {
+        CloseHandle(asyncContext);
+    }
+}
+
+bool IsRegularFile(HANDLE file)
+{
+    return GetFileType(file) == FILE_TYPE_DISK;
+}
+
+bool DuplicateFile(HANDLE file, HANDLE &dupFile)
+{
+    return !!DuplicateHandle(GetCurrentProcess(), file, GetCurrentProcess(), &dupFile, 0, FALSE, DUPLICATE_SAME_ACCESS);
+}
+#else
+const char *GetSmallString(const char *s)
+{
+    return s;
+}
+
+int64_t SeekFile(int file, int64_t offset)
+{
+    return lseek(file, offset < 0 ? offset + 1 : offset, offset < 0 ? SEEK_END : SEEK_SET);
+}
+
+// asyncRemainingProc returns the remaining time until the asynchronous reading is canceled
+template<class P>
+int ReadFileToBuffer(int file, uint8_t *buf, size_t count, int &asyncContext, P asyncRemainingProc)
+{
+    for (;;) {
+        int ret = static_cast<int>(read(file, buf, count));
+        auto remaining = std::chrono::microseconds::zero();
+        if (ret >= 0 || !asyncContext || (errno != EAGAIN && errno != EWOULDBLOCK) ||
+            (remaining = std::chrono::duration_cast<std::chrono::microseconds>(asyncRemainingProc())).count() <= 0) {
+            // Asynchronous FIFO reading can be opened before a writer opens it, then read() returns 0.
+            if (asyncContext && ret > 0) {
+                // Connected.
+                asyncContext = 2;
+            }
+            // For asynchronous, returns -1 for EOF
+            // For synchronous, 0 means EOF
+            return asyncContext == 2 && ret == 0 ? -1 : ret;
+        }
+        fd_set rfd;
+        FD_ZERO(&rfd);
+        FD_SET(file, &rfd);
+        timeval tv = {};
+        tv.tv_sec = static_cast<long>(std::min<int64_t>(remaining.count() / 1000000, 60));
+        tv.tv_usec = static_cast<long>(tv.tv_sec < 60 ? remaining.count() % 1000000 : 0);
+        if (select(file + 1, &rfd, nullptr, nullptr, &tv) < 0) {
+            return -1;
+        }
+    }
+}
+
+void CloseFile(int file, int asyncContext)
+{
+    static_cast<void>(asyncContext);
+    if (file >= 0) {
+        close(file);
+    }
+}
+
+bool IsRegularFile(int file)
+{
+    struct stat st;
+    return fstat(file, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+bool DuplicateFile(int file, int &dupFile)
+{
+    dupFile = dup(file);
+    return dupFile >= 0;
+}
+
+// Opens a file, FIFO or Unix domain socket for output.
+FILE *OpenOutputFile(const char *name)
+{
+    struct stat st;
+    int fd;
+    if (stat(name, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (strlen(name) >= sizeof(addr.sun_path)) {
+            return nullptr;
+        }
+        strcpy(addr.sun_path, name);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    else {
+        fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+    FILE *fp = fd >= 0 ? fdopen(fd, "wb") : nullptr;
+    if (!fp && fd >= 0) {
+        close(fd);
+    }
+    return fp;
+}
+
+// Reads a regular file through a read-only memory-mapped window instead of read().
+class CMappedFile
+{
+public:
+    CMappedFile() : m_file(-1), m_map(nullptr), m_mapPos(0), m_mapSize(0), m_fileSize(0), m_pos(0) {}
+    ~CMappedFile() { Unmap(); }
+    bool IsOpen() const { return m_file >= 0; }
+
+    bool Open(int file)
+    {
+        struct stat st;
+        if (fstat(file, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+        m_fileSize = st.st_size;
+        m_pos = lseek(file, 0, SEEK_CUR);
+        if (m_pos < 0) {
+            return false;
+        }
+        m_file = file;
+        return true;
+    }
+
+    // Same as SeekFile()
+    int64_t Seek(int64_t offset)
+    {
+        if (offset < 0) {
+            UpdateFileSize();
+            offset += m_fileSize + 1;
+            if (offset < 0) {
+                return -1;
+            }
+        }
+        m_pos = offset;
+        return m_pos;
+    }
+
+    // Maps at most "count" bytes following the current position and advances the position.
+    // On return, "data" points to the mapped byte that is "back" bytes before the previous position.
+    // Returns the number of bytes, 0 for EOF (the file may still grow) or -1 for error.
+    int Read(size_t count, size_t back, const uint8_t *&data)
+    {
+        if (m_pos + static_cast<int64_t>(count) > m_fileSize) {
+            // Follow growing files
+            UpdateFileSize();
+        }
+        int64_t n = std::max<int64_t>(std::min(static_cast<int64_t>(count), m_fileSize - m_pos), 0);
+        int64_t beginPos = m_pos - static_cast<int64_t>(back);
+        if (!m_map || beginPos < m_mapPos || m_pos + n > m_mapPos + static_cast<int64_t>(m_mapSize)) {
+            // Pages past the end of the file are not accessed until the file grows.
+            int64_t mapPos = beginPos / WINDOW_ALIGN * WINDOW_ALIGN;
+            void *p = mmap(nullptr, WINDOW_SIZE, PROT_READ, MAP_SHARED, m_file, mapPos);
+            if (p == MAP_FAILED) {
+                // Keep the current window since "data" may still point to it
+                return -1;
+            }
+            Unmap();
+            m_map = static_cast<uint8_t *>(p);
+            m_mapPos = mapPos;
+            m_mapSize = WINDOW_SIZE;
+            madvise(m_map, m_mapSize, MADV_SEQUENTIAL);
+        }
+        data = m_map + (beginPos - m_mapPos);
+        m_pos += n;
+        return static_cast<int>(n);
+    }
+
+    // Returns the file offset of the mapped data, or -1 if not mapped.
+    int64_t GetOffset(const uint8_t *data, size_t size) const
+    {
+        return m_map && m_map <= data && data + size <= m_map + m_mapSize ? m_mapPos + (data - m_map) : -1;
+    }
+
+private:
+    static const int64_t WINDOW_ALIGN = 1024 * 1024;
+    static const size_t WINDOW_SIZE = 16 * 1024 * 1024;
+
+    void UpdateFileSize()
+    {
+        struct stat st;
+        if (fstat(m_file, &st) == 0) {
+            m_fileSize = st.st_size;
+        }
+    }
+
+    void Unmap()
+    {
+        if (m_map) {
+            munmap(m_map, m_mapSize);
+            m_map = nullptr;
+        }
+    }
+
+    int m_file;
+    uint8_t *m_map;
+    int64_t m_mapPos;
+    size_t m_mapSize;
+    int64_t m_fileSize;
+    int64_t m_pos;
+};
+
+#ifdef __linux__
+// Preallocates a regular output file ahead and starts writeback of written ranges periodically,
+// so that dirty pages don't pile up in the page cache and get flushed in bursts.
+class CWritebackControl
+{
+public:
+    CWritebackControl() : m_file(-1), m_pos(0), m_allocEnd(0), m_syncPos(0) {}
+    ~CWritebackControl() { Close(); }
+
+    bool Open(int file)
+    {
+        struct stat st;
+        if (fstat(file, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+        m_pos = lseek(file, 0, SEEK_CUR);
+        if (m_pos < 0) {
+            return false;
+        }
+        m_allocEnd = m_pos;
+        m_syncPos = m_pos;
+        m_file = file;
+        return true;
+    }
+
+    // Notifies that "size" bytes are passed to the stream, whose buffer must be smaller than SYNC_STEP.
+    void Advance(size_t size)
+    {
+        if (m_file < 0) {
+            return;
+        }
+        m_pos += size;
+        if (m_pos > m_allocEnd) {
+            // Failure (not supported by the file system etc.) is not a problem.
+            int64_t len = (m_pos - m_allocEnd + ALLOC_STEP - 1) / ALLOC_STEP * ALLOC_STEP;
+            fallocate(m_file, FALLOC_FL_KEEP_SIZE, m_allocEnd, len);
+            m_allocEnd += len;
+        }
+        // Ranges passed more than SYNC_STEP ago have left the stream buffer, which is at most 4MiB (-w).
+        while (m_pos - m_syncPos >= 2 * SYNC_STEP) {
+            sync_file_range(m_file, m_syncPos, SYNC_STEP, SYNC_FILE_RANGE_WRITE);
+            if (m_syncPos >= SYNC_STEP) {
+                // Wait for the previous range so that writeback doesn't fall behind.
+                sync_file_range(m_file, m_syncPos - SYNC_STEP, SYNC_STEP,
+                                SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            }
+            m_syncPos += SYNC_STEP;
+        }
+    }
+
+    // Releases the unused preallocation. All data must be written before.
+    void Close()
+    {
+        if (m_file >= 0) {
+            struct stat st;
+            if (fstat(m_file, &st) == 0 && st.st_size < m_allocEnd) {
+                // Truncating to the same size frees blocks beyond the end of the file
+                if (ftruncate(m_file, st.st_size) != 0) {
+                    fprintf(stderr, "Warning: ftruncate failed.\n");
+                }
+            }
+            m_file = -1;
+        }
+    }
+
+private:
+    static const int64_t ALLOC_STEP = 64 * 1024 * 1024;
+    static const int64_t SYNC_STEP = 8 * 1024 * 1024;
+
+    int m_file;
+    int64_t m_pos;
+    int64_t m_allocEnd;
+    int64_t m_syncPos;
+};
+
+const int PIPE_SIZE_FOR_SPLICE = 1024 * 1024;
+
+// Writes to the output pipe. Long runs of data that are also in the input file are moved with splice() instead of being copied.
+class CSpliceWriter
+{
+public:
+    CSpliceWriter() : m_inFile(-1), m_outPipe(-1) {}
+    bool IsOpen() const { return m_outPipe >= 0; }
+
+    bool Open(int inFile, int outPipe)
+    {
+        struct stat st;
+        if (fstat(outPipe, &st) != 0 || !S_ISFIFO(st.st_mode)) {
+            return false;
+        }
+        fcntl(outPipe, F_SETPIPE_SZ, PIPE_SIZE_FOR_SPLICE);
+        m_inFile = inFile;
+        m_outPipe = outPipe;
+        return true;
+    }
+
+    // "offset" is the input file offset of the data, or -1 if it's not from the input.
+    bool Write(const uint8_t *data, size_t size, int64_t offset)
+    {
+        if (offset < 0 || size < SPLICE_MIN_SIZE) {
+            // Short runs are gathered to reduce syscalls
+            m_buf.insert(m_buf.end(), data, data + size);
+            return m_buf.size() < BUF_SIZE || Flush();
+        }
+        if (!Flush()) {
+            return false;
+        }
+        while (size > 0) {
+            loff_t off = offset;
+            ssize_t ret = splice(m_inFile, &off, m_outPipe, nullptr, size, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (ret <= 0) {
+                if (ret < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (ret < 0 && errno == EPIPE) {
+                    return false;
+                }
+                // Not supported by the file system etc.
+                return WriteAll(data, size);
+            }
+            data += ret;
+            size -= ret;
+            offset += ret;
+        }
+        return true;
+    }
+
+    bool Flush()
+    {
+        bool ret = WriteAll(m_buf.data(), m_buf.size());
+        m_buf.clear();
+        return ret;
+    }
+
+private:
+    static const size_t SPLICE_MIN_SIZE = 188 * 16;
+    static const size_t BUF_SIZE = 65536;
+
+    bool WriteAll(const uint8_t *data, size_t size)
+    {
+        while (size > 0) {
+            ssize_t ret = write(m_outPipe, data, size);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret <= 0) {
+                return false;
+            }
+            data += ret;
+            size -= ret;
+        }
+        return true;
+    }
+
+    int m_inFile;
+    int m_outPipe;
+    std::vector<uint8_t> m_buf;
+};
+
+// Waits for data appended to a file with inotify, or for data in a pipe with epoll.
+class CInputWaiter
+{
+public:
+    CInputWaiter() : m_epoll(-1), m_inotify(-1), m_watching(false) {}
+    ~CInputWaiter()
+    {
+        if (m_inotify >= 0) {
+            close(m_inotify);
+        }
+        if (m_epoll >= 0) {
+            close(m_epoll);
+        }
+    }
+
+    bool Open(int file)
+    {
+        struct stat st;
+        if (fstat(file, &st) != 0) {
+            return false;
+        }
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll < 0) {
+            return false;
+        }
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        if (S_ISREG(st.st_mode)) {
+            // Regular files are always "ready" for epoll, so watch modifications instead
+            m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            char path[32];
+            sprintf(path, "/proc/self/fd/%d", file);
+            if (m_inotify < 0 || inotify_add_watch(m_inotify, path, IN_MODIFY) < 0 ||
+                epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_inotify, &ev) != 0) {
+                return false;
+            }
+            m_watching = true;
+        }
+        else if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, file, &ev) == 0) {
+            m_watching = true;
+        }
+        return m_watching;
+    }
+
+    // Returns false if cannot wait, then the caller should sleep instead.
+    bool Wait(std::chrono::milliseconds timeout)
+    {
+        if (!m_watching) {
+            return false;
+        }
+        epoll_event ev;
+        int ret = epoll_wait(m_epoll, &ev, 1, static_cast<int>(std::min<int64_t>(timeout.count(), 60000)));
+        if (ret > 0 && m_inotify >= 0) {
+            // Consume events
+            char events[4096];
+            while (read(m_inotify, events, sizeof(events)) > 0) {
+            }
+        }
+        // Closed pipes are always "ready"
+        return ret == 0 || (ret > 0 && (ev.events & EPOLLIN));
+    }
+
+private:
+    int m_epoll;
+    int m_inotify;
+    bool m_watching;
+};
+
+// Keeps several reads from a regular file and writes to the output in flight with io_uring.
+class CUringIo
+{
+public:
+    CUringIo()
+        : m_ring(-1), m_sqMap(nullptr), m_cqMap(nullptr), m_sqes(nullptr), m_sqMapSize(0), m_cqMapSize(0), m_sqesSize(0)
+        , m_toSubmit(0), m_inFlight(0), m_fixed(false), m_inFile(-1), m_readPos(0), m_issuePos(0)
+        , m_outFile(-1), m_outSeekable(false), m_outPos(0), m_writeSlot(-1), m_writesInFlight(0), m_writeFailed(false) {}
+    ~CUringIo() { Close(); }
+    bool IsReading() const { return m_inFile >= 0; }
+    bool IsWriting() const { return m_outFile >= 0; }
+
+    // Input is used only if it is a regular file. Pass -1 for unused files.
+    bool Open(int inFile, int outFile)
+    {
+        struct stat st;
+        if (inFile >= 0 && (fstat(inFile, &st) != 0 || !S_ISREG(st.st_mode))) {
+            inFile = -1;
+        }
+        if ((inFile < 0 && outFile < 0) || !Setup()) {
+            return false;
+        }
+        if (inFile >= 0) {
+            m_readPos = lseek(inFile, 0, SEEK_CUR);
+            if (m_readPos >= 0) {
+                m_issuePos = m_readPos;
+                m_inFile = inFile;
+            }
+        }
+        if (outFile >= 0) {
+            // Regular files are written at explicit offsets, so writes can be reordered.
+            // Others (or appending) must be written one at a time.
+            int fl = fcntl(outFile, F_GETFL);
+            m_outPos = fstat(outFile, &st) == 0 && S_ISREG(st.st_mode) && fl != -1 && !(fl & O_APPEND) ? lseek(outFile, 0, SEEK_CUR) : -1;
+            m_outSeekable = m_outPos >= 0;
+            m_outFile = outFile;
+        }
+        return IsReading() || IsWriting();
+    }
+
+    // Same as SeekFile()
+    int64_t Seek(int64_t offset)
+    {
+        if (offset < 0) {
+            struct stat st;
+            if (fstat(m_inFile, &st) != 0) {
+                return -1;
+            }
+            offset += st.st_size + 1;
+            if (offset < 0) {
+                return -1;
+            }
+        }
+        DiscardReads();
+        m_readPos = m_issuePos = offset;
+        return offset;
+    }
+
+    // Returns the number of bytes, 0 for EOF (the file may still grow) or -1 for error.
+    int Read(uint8_t *buf, size_t count)
+    {
+        size_t copied = 0;
+        for (;;) {
+            IssueReads();
+            int i = 0;
+            for (; i < READ_DEPTH; ++i) {
+                SLOT &s = m_slots[i];
+                if (s.state != SLOT_FREE && !s.stale && s.offset + static_cast<int64_t>(s.done) == m_readPos) {
+                    break;
+                }
+            }
+            if (i < READ_DEPTH && m_slots[i].state == SLOT_READY) {
+                SLOT &s = m_slots[i];
+                if (s.result < 0) {
+                    s.state = SLOT_FREE;
+                    DiscardReads();
+                    m_issuePos = m_readPos;
+                    return copied > 0 ? static_cast<int>(copied) : -1;
+                }
+                size_t n = std::min(count - copied, static_cast<size_t>(s.result) - s.done);
+                std::copy(m_bufs.data() + i * BUF_SIZE + s.done, m_bufs.data() + i * BUF_SIZE + s.done + n, buf + copied);
+                s.done += n;
+                m_readPos += n;
+                copied += n;
+                if (s.done == static_cast<size_t>(s.result)) {
+                    s.state = SLOT_FREE;
+                    if (s.result < static_cast<int>(BUF_SIZE)) {
+                        // Reached the end of the file. Following reads may have seen appended data, so issue them again.
+                        DiscardReads();
+                        m_issuePos = m_readPos;
+                        return static_cast<int>(copied);
+                    }
+                }
+                if (copied == count) {
+                    Submit(false);
+                    return static_cast<int>(copied);
+                }
+            }
+            else if (copied > 0) {
+                Submit(false);
+                return static_cast<int>(copied);
+            }
+            else if (!Submit(true)) {
+                return -1;
+            }
+        }
+    }
+
+    // Returns false if this or any previous write failed.
+    bool Write(const uint8_t *data, size_t size)
+    {
+        while (size > 0 && !m_writeFailed) {
+            if (m_writeSlot < 0) {
+                for (int i = READ_DEPTH; i < NUM_SLOTS; ++i) {
+                    if (m_slots[i].state == SLOT_FREE) {
+                        m_writeSlot = i;
+                        m_slots[i].size = 0;
+                        m_slots[i].state = SLOT_FILLING;
+                        break;
+                    }
+                }
+                if (m_writeSlot < 0) {
+                    IssueWrites();
+                    if (!Submit(true)) {
+                        m_writeFailed = true;
+                    }
+                    continue;
+                }
+            }
+            SLOT &s = m_slots[m_writeSlot];
+            size_t n = std::min(size, BUF_SIZE - s.size);
+            std::copy(data, data + n, m_bufs.data() + m_writeSlot * BUF_SIZE + s.size);
+            s.size += n;
+            data += n;
+            size -= n;
+            if (s.size == BUF_SIZE) {
+                QueueWrite();
+                IssueWrites();
+            }
+        }
+        if (m_writeSlot >= 0 && m_writesInFlight == 0 && m_writeQueue.empty()) {
+            // The output is idle, so don't wait for the buffer to fill up
+            QueueWrite();
+        }
+        IssueWrites();
+        Submit(false);
+        return !m_writeFailed;
+    }
+
+    // Waits for all writes. Returns false if any write failed.
+    bool Flush()
+    {
+        if (m_writeSlot >= 0) {
+            QueueWrite();
+        }
+        IssueWrites();
+        while (!m_writeFailed && m_writesInFlight > 0) {
+            if (!Submit(true)) {
+                m_writeFailed = true;
+            }
+            IssueWrites();
+        }
+        if (m_outSeekable) {
+            // Leave the file position at the end of the output
+            lseek(m_outFile, m_outPos, SEEK_SET);
+        }
+        return !m_writeFailed;
+    }
+
+private:
+    static const int READ_DEPTH = 4;
+    static const int NUM_SLOTS = 8;
+    static const size_t BUF_SIZE = 65536;
+    enum SLOT_STATE { SLOT_FREE, SLOT_BUSY, SLOT_READY, SLOT_FILLING, SLOT_QUEUED };
+    struct SLOT
+    {
+        SLOT_STATE state;
+        bool stale;
+        int result;
+        int64_t offset;
+        size_t size;
+        size_t done;
+    };
+
+    bool Setup()
+    {
+        io_uring_params params = {};
+        m_ring = static_cast<int>(syscall(__NR_io_uring_setup, NUM_SLOTS, &params));
+        if (m_ring < 0) {
+            return false;
+        }
+        m_sqMapSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        m_cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            m_sqMapSize = m_cqMapSize = std::max(m_sqMapSize, m_cqMapSize);
+        }
+        void *p = mmap(nullptr, m_sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+        if (p == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        m_sqMap = static_cast<uint8_t *>(p);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            m_cqMap = m_sqMap;
+        }
+        else {
+            p = mmap(nullptr, m_cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+            if (p == MAP_FAILED) {
+                Close();
+                return false;
+            }
+            m_cqMap = static_cast<uint8_t *>(p);
+        }
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        p = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+        if (p == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        m_sqes = static_cast<io_uring_sqe *>(p);
+        m_sqTail = reinterpret_cast<uint32_t *>(m_sqMap + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<uint32_t *>(m_sqMap + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<uint32_t *>(m_sqMap + params.sq_off.array);
+        m_cqHead = reinterpret_cast<uint32_t *>(m_cqMap + params.cq_off.head);
+        m_cqTail = reinterpret_cast<uint32_t *>(m_cqMap + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<uint32_t *>(m_cqMap + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe *>(m_cqMap + params.cq_off.cqes);
+
+        m_bufs.resize(NUM_SLOTS * BUF_SIZE);
+        iovec iov[NUM_SLOTS];
+        for (int i = 0; i < NUM_SLOTS; ++i) {
+            iov[i].iov_base = m_bufs.data() + i * BUF_SIZE;
+            iov[i].iov_len = BUF_SIZE;
+            m_slots[i] = SLOT();
+        }
+        // May fail due to RLIMIT_MEMLOCK, then use normal buffers.
+        m_fixed = syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_BUFFERS, iov, NUM_SLOTS) == 0;
+        return true;
+    }
+
+    void Close()
+    {
+        if (m_ring >= 0) {
+            // Buffers must not be freed while the kernel is accessing them
+            while (m_inFlight > 0) {
+                if (!Submit(true)) {
+                    break;
+                }
+            }
+            if (m_sqes) {
+                munmap(m_sqes, m_sqesSize);
+            }
+            if (m_cqMap && m_cqMap != m_sqMap) {
+                munmap(m_cqMap, m_cqMapSize);
+            }
+            if (m_sqMap) {
+                munmap(m_sqMap, m_sqMapSize);
+            }
+            close(m_ring);
+            m_ring = -1;
+        }
+    }
+
+    void Prepare(uint8_t opcode, int file, int i, int64_t offset)
+    {
+        // The ring has room for all slots.
+        uint32_t tail = *m_sqTail;
+        uint32_t index = tail & m_sqMask;
+        SLOT &s = m_slots[i];
+        io_uring_sqe &sqe = m_sqes[index];
+        sqe = io_uring_sqe();
+        sqe.opcode = opcode;
+        if (!m_fixed) {
+            sqe.opcode = opcode == IORING_OP_READ_FIXED ? IORING_OP_READ : IORING_OP_WRITE;
+        }
+        sqe.fd = file;
+        sqe.off = offset < 0 ? ~static_cast<uint64_t>(0) : offset;
+        sqe.addr = reinterpret_cast<uintptr_t>(m_bufs.data() + i * BUF_SIZE + s.done);
+        sqe.len = static_cast<uint32_t>((opcode == IORING_OP_READ_FIXED ? BUF_SIZE : s.size) - s.done);
+        sqe.buf_index = static_cast<uint16_t>(i);
+        sqe.user_data = i;
+        m_sqArray[index] = index;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+        s.state = SLOT_BUSY;
+        ++m_toSubmit;
+        ++m_inFlight;
+    }
+
+    // Submits prepared requests and handles completions. Waits for at least one completion if "wait" is true.
+    bool Submit(bool wait)
+    {
+        if (m_toSubmit > 0 || wait) {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, m_ring, m_toSubmit, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (ret < 0) {
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                    return false;
+                }
+            }
+            else {
+                m_toSubmit -= std::min(static_cast<uint32_t>(ret), m_toSubmit);
+            }
+        }
+        uint32_t head = *m_cqHead;
+        for (; head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE); ++head) {
+            const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            int i = static_cast<int>(cqe.user_data);
+            SLOT &s = m_slots[i];
+            --m_inFlight;
+            if (i < READ_DEPTH) {
+                s.state = s.stale ? SLOT_FREE : SLOT_READY;
+                s.stale = false;
+                s.result = cqe.res;
+            }
+            else {
+                --m_writesInFlight;
+                if (cqe.res < 0 && cqe.res != -EINTR && cqe.res != -EAGAIN) {
+                    s.state = SLOT_FREE;
+                    m_writeFailed = true;
+                }
+                else {
+                    s.done += std::max(cqe.res, 0);
+                    if (s.done < s.size) {
+                        // Short write, continue it
+                        s.state = SLOT_QUEUED;
+                        m_writeQueue.push_front(i);
+                    }
+                    else {
+                        s.state = SLOT_FREE;
+                    }
+                }
+            }
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    void IssueReads()
+    {
+        for (int i = 0; m_inFile >= 0 && i < READ_DEPTH; ++i) {
+            if (m_slots[i].state == SLOT_FREE) {
+                m_slots[i].offset = m_issuePos;
+                m_slots[i].done = 0;
+                Prepare(IORING_OP_READ_FIXED, m_inFile, i, m_issuePos);
+                m_issuePos += BUF_SIZE;
+            }
+        }
+    }
+
+    void DiscardReads()
+    {
+        for (int i = 0; i < READ_DEPTH; ++i) {
+            if (m_slots[i].state == SLOT_BUSY) {
+                m_slots[i].stale = true;
+            }
+            else {
+                m_slots[i].state = SLOT_FREE;
+            }
+        }
+    }
+
+    void QueueWrite()
+    {
+        SLOT &s = m_slots[m_writeSlot];
+        s.state = SLOT_QUEUED;
+        s.done = 0;
+        s.offset = m_outPos;
+        if (m_outSeekable) {
+            m_outPos += s.size;
+        }
+        m_writeQueue.push_back(m_writeSlot);
+        m_writeSlot = -1;
+    }
+
+    void IssueWrites()
+    {
+        while (!m_writeFailed && !m_writeQueue.empty() && (m_outSeekable || m_writesInFlight == 0)) {
+            int i = m_writeQueue.front();
+            m_writeQueue.pop_front();
+            Prepare(IORING_OP_WRITE_FIXED, m_outFile, i, m_outSeekable ? m_slots[i].offset + m_slots[i].done : -1);
+            ++m_writesInFlight;
+        }
+    }
+
+    int m_ring;
+    uint8_t *m_sqMap;
+    uint8_t *m_cqMap;
+    io_uring_sqe *m_sqes;
+    size_t m_sqMapSize;
+    size_t m_cqMapSize;
+    size_t m_sqesSize;
+    uint32_t *m_sqTail;
+    uint32_t m_sqMask;
+    uint32_t *m_sqArray;
+    uint32_t *m_cqHead;
+    uint32_t *m_cqTail;
+    uint32_t m_cqMask;
+    io_uring_cqe *m_cqes;
+    uint32_t m_toSubmit;
+    int m_inFlight;
+    bool m_fixed;
+    std::vector<uint8_t> m_bufs;
+    SLOT m_slots[NUM_SLOTS];
+    int m_inFile;
+    int64_t m_readPos;
+    int64_t m_issuePos;
+    int m_outFile;
+    bool m_outSeekable;
+    int64_t m_outPos;
+    int m_writeSlot;
+    std::deque<int> m_writeQueue;
+    int m_writesInFlight;
+    bool m_writeFailed;
+};
+#endif
+#endif
+
+void SetCurrentThreadCpu(int cpu)
+{
+#ifdef _WIN32
+    if (cpu < 64) {
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+    }
+#elif defined(__linux__)
+    if (cpu < CPU_SETSIZE) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+#else
+    static_cast<void>(cpu);
+#endif
+}
+
+// Reads from "offset" up to "limit" and returns the offset of the first packet carrying PCR of "pcrPid", or -1 if not found.
+// If pcrPid < 0, any PID is accepted and pcrPid is set.
+template<class F>
+int64_t SamplePcr(F readAt, int64_t offset, int64_t limit, int &pcrPid, int64_t &pcr)
+{
+    std::vector<uint8_t> buf(65536);
+    while (offset < limit) {
+        int n = readAt(offset, buf.data(), static_cast<size_t>(std::min<int64_t>(buf.size(), limit - offset)));
+        if (n <= 0) {
+            break;
+        }
+        int unitSize = 0;
+        int bufPos = resync_ts(buf.data(), n, &unitSize);
+        if (unitSize == 0) {
+            offset += n;
+            continue;
+        }
+        for (int i = bufPos; i + unitSize <= n; i += unitSize) {
+            int pid = extract_ts_header_pid(&buf[i]);
+            if (pcrPid < 0 || pid == pcrPid) {
+                pcr = extract_ts_pcr(&buf[i]);
+                if (pcr >= 0) {
+                    pcrPid = pid;
+                    return offset + i;
+                }
+            }
+        }
+        // Keep the partial packet
+        offset += std::max(bufPos + (n - bufPos) / unitSize * unitSize, 1);
+    }
+    return -1;
+}
+
+// Returns the offset of a packet whose PCR is before "seekSec" seconds from the first PCR by binary search, or -1 on
+// failure. The first PID carrying PCR is the reference. targetPcr is set to the PCR of the time to seek.
+template<class F>
+int64_t SearchPcrOffset(F readAt, int64_t fileSize, int seekSec, int &pcrPid, int64_t &targetPcr)
+{
+    // PCR must appear at least every 100 msec, so these are large enough
+    const int64_t SAMPLE_LIMIT = 4 * 1024 * 1024;
+    const int64_t SEARCH_RESOLUTION = 256 * 1024;
+    int64_t firstPcr;
+    pcrPid = -1;
+    if (SamplePcr(readAt, 0, std::min(fileSize, SAMPLE_LIMIT), pcrPid, firstPcr) < 0) {
+        return -1;
+    }
+    targetPcr = (firstPcr + seekSec * 90000LL) & 0x1ffffffff;
+    int64_t lo = 0;
+    int64_t hi = fileSize;
+    while (hi - lo > SEARCH_RESOLUTION) {
+        int64_t mid = lo + (hi - lo) / 2;
+        int64_t pcr;
+        int64_t pos = SamplePcr(readAt, mid, std::min(hi, mid + SAMPLE_LIMIT), pcrPid, pcr);
+        if (pos >= 0 && ((0x200000000 + pcr - firstPcr) & 0x1ffffffff) < seekSec * 90000LL) {
+            lo = pos;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Detects the end of a time range by PCR.
+class CPcrRangeEnd
+{
+public:
+    // If pcrPid < 0, the first PID carrying PCR is the reference. If basePcr < 0, the range begins at the first PCR.
+    CPcrRangeEnd(int rangeSec, int pcrPid, int64_t basePcr) : m_range(rangeSec * 90000LL), m_pcrPid(pcrPid), m_basePcr(basePcr) {}
+    bool IsEnabled() const { return m_range != 0; }
+
+    // Returns true if the "index"-th packet of the decoded batch is beyond the end.
+    bool IsPassed(const TS_HEADERS &headers, size_t index)
+    {
+        int pid = headers.pid[index];
+        if (m_range != 0 && headers.pcr_flag[index] && (m_pcrPid < 0 || pid == m_pcrPid)) {
+            int64_t pcr = extract_ts_pcr(headers.packet[index]);
+            if (pcr >= 0) {
+                m_pcrPid = pid;
+                if (m_basePcr < 0) {
+                    m_basePcr = pcr;
+                }
+                // Packets slightly before the beginning have "negative" differences
+                int64_t pcrDiff = (0x200000000 + pcr - m_basePcr) & 0x1ffffffff;
+                return pcrDiff < 0x100000000 && pcrDiff >= m_range;
+            }
+        }
+        return false;
+    }
+
+private:
+    int64_t m_range;
+    int m_pcrPid;
+    int64_t m_basePcr;
+};
+
+// Limits the sustained rate to "rate" bytes per second, allowing bursts of "burst" bytes.
+// Tokens are refilled continuously, so that consumption is spread evenly.
+class CTokenBucket
+{
+public:
+    CTokenBucket(int64_t rate, int64_t burst)
+        : m_rate(rate), m_burst(burst), m_tokens(static_cast<double>(burst)), m_lastTime(std::chrono::steady_clock::now()) {}
+
+    // Consumes "n" tokens and returns the time to wait until the balance is no longer negative.
+    std::chrono::milliseconds Consume(int64_t n)
+    {
+        auto nowTime = std::chrono::steady_clock::now();
+        double elapsedSec = std::chrono::duration_cast<std::chrono::duration<double>>(nowTime - m_lastTime).count();
+        m_lastTime = nowTime;
+        m_tokens = std::min(m_tokens + elapsedSec * m_rate, static_cast<double>(m_burst)) - n;
+        return std::chrono::milliseconds(m_tokens >= 0 ? 0 : static_cast<int64_t>(-m_tokens * 1000 / m_rate) + 1);
+    }
+
+private:
+    int64_t m_rate;
+    int64_t m_burst;
+    double m_tokens;
+    std::chrono::steady_clock::time_point m_lastTime;
+};
+
+// Bounds the time that complete packets stay in the read buffer, and sizes reads by the throughput.
+class CLatencyTarget
+{
+public:
+    CLatencyTarget(int latencyMsec)
+        : m_latency(latencyMsec), m_pending(false), m_measuredBytes(0), m_measurementTime(std::chrono::steady_clock::now()) {}
+    bool IsEnabled() const { return m_latency.count() != 0; }
+
+    // Tells whether the buffer has packets to be processed. The deadline starts when they become available.
+    void Update(bool hasPackets)
+    {
+        if (!IsEnabled() || !hasPackets) {
+            m_pending = false;
+        }
+        else if (!m_pending) {
+            m_pending = true;
+            m_pendingTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Returns true if the pending packets have reached the deadline.
+    bool IsExpired() const
+    {
+        return m_pending && std::chrono::steady_clock::now() >= m_pendingTime + m_latency;
+    }
+
+    // Returns "limit", or the remaining time until the deadline if it is shorter.
+    std::chrono::steady_clock::duration GetRemaining(std::chrono::steady_clock::duration limit) const
+    {
+        if (m_pending) {
+            limit = std::min(limit, m_pendingTime + m_latency - std::chrono::steady_clock::now());
+        }
+        return limit;
+    }
+
+    // Returns the read size needed to keep up with the throughput, in steps of "minSize".
+    size_t GetReadSize(size_t readSize, size_t minSize, size_t maxSize, int64_t readBytes)
+    {
+        m_measuredBytes += readBytes;
+        auto nowTime = std::chrono::steady_clock::now();
+        double elapsedSec = std::chrono::duration_cast<std::chrono::duration<double>>(nowTime - m_measurementTime).count();
+        if (elapsedSec >= 0.1) {
+            // Bytes arriving within the latency
+            double needed = m_measuredBytes / elapsedSec * m_latency.count() / 1000;
+            readSize = std::min(std::max(static_cast<size_t>(needed / minSize + 1) * minSize, minSize), maxSize);
+            m_measuredBytes = 0;
+            m_measurementTime = nowTime;
+        }
+        return readSize;
+    }
+
+private:
+    std::chrono::milliseconds m_latency;
+    bool m_pending;
+    std::chrono::steady_clock::time_point m_pendingTime;
+    int64_t m_measuredBytes;
+    std::chrono::steady_clock::time_point m_measurementTime;
+};
+
+// Single-producer single-consumer ring of fixed-size blocks.
+// Only waiting on a full or empty ring takes the lock.
+class CBlockRing
+{
+public:
+    struct BLOCK
+    {
+        std::vector<uint8_t> data;
+        int size;
+    };
+
+    CBlockRing(size_t blockCount, size_t blockSize) : m_blocks(blockCount), m_head(0), m_tail(0), m_closed(false), m_waiters(0)
+    {
+        for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+            it->data.resize(blockSize);
+            it->size = 0;
+        }
+    }
+    bool Empty() const { return m_head.load() == m_tail.load(); }
+
+    // For the producer. Returns nullptr if closed.
+    BLOCK *WaitForFree()
+    {
+        Wait([this]() { return m_closed.load() || m_tail.load() - m_head.load() < m_blocks.size(); });
+        return m_closed.load() ? nullptr : &m_blocks[m_tail.load() % m_blocks.size()];
+    }
+
+    void Push()
+    {
+        ++m_tail;
+        Notify();
+    }
+
+    // For the consumer. Returns nullptr if closed and empty.
+    BLOCK *WaitForFilled()
+    {
+        Wait([this]() { return m_closed.load() || m_tail.load() != m_head.load(); });
+        return Front();
+    }
+
+    // Returns nullptr if empty.
+    BLOCK *Front()
+    {
+        return m_tail.load() != m_head.load() ? &m_blocks[m_head.load() % m_blocks.size()] : nullptr;
+    }
+
+    void Pop()
+    {
+        ++m_head;
+        Notify();
+    }
+
+    void Close()
+    {
+        m_closed = true;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cond.notify_all();
+    }
+
+    // Must not be called while the other side is working.
+    void Reset()
+    {
+        m_head = 0;
+        m_tail = 0;
+        m_closed = false;
+    }
+
+private:
+    void Notify()
+    {
+        if (m_waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cond.notify_all();
+        }
+    }
+
+    template<class P>
+    void Wait(P pred)
+    {
+        if (!pred()) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_waiters;
+            m_cond.wait(lock, pred);
+            --m_waiters;
+        }
+    }
+
+    std::vector<BLOCK> m_blocks;
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+    std::atomic<bool> m_closed;
+    std::atomic<int> m_waiters;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+};
+
+// Reads the input ahead of the main loop on its own thread.
+class CReadThread
+{
+public:
+    CReadThread() : m_ring(std::make_shared<CBlockRing>(8, 65536)), m_cpu(-1), m_mayBlock(false), m_offset(0) {}
+    ~CReadThread() { Close(); }
+    bool IsEnabled() const { return !!m_readProc; }
+
+    // "readProc" has the same result as ReadFileToBuffer() in synchronous mode.
+    // If "mayBlock" (e.g. on a pipe), "readProc" must not depend on the input being open after Close().
+    void Enable(const std::function<int (uint8_t *, size_t)> &readProc, int cpu, bool mayBlock)
+    {
+        m_readProc = readProc;
+        m_cpu = cpu;
+        m_mayBlock = mayBlock;
+    }
+
+    // Ends reading. Must be called before the input is closed.
+    void Close()
+    {
+        if (m_thread.joinable()) {
+            m_ring->Close();
+            if (m_mayBlock) {
+                // The thread may be blocked, so don't wait for it
+                m_thread.detach();
+            }
+            else {
+                m_thread.join();
+            }
+        }
+    }
+
+    // Returns the number of bytes, 0 for EOF or -1 for error.
+    int Read(uint8_t *buf, size_t count)
+    {
+        if (!m_thread.joinable()) {
+            Start();
+        }
+        size_t copied = 0;
+        for (CBlockRing::BLOCK *block = m_ring->WaitForFilled(); block; block = m_ring->Front()) {
+            if (block->size <= 0) {
+                if (copied == 0) {
+                    // The thread has ended
+                    int ret = block->size;
+                    m_ring->Pop();
+                    m_thread.join();
+                    return ret;
+                }
+                break;
+            }
+            size_t n = std::min(count - copied, static_cast<size_t>(block->size) - m_offset);
+            std::copy(block->data.begin() + m_offset, block->data.begin() + m_offset + n, buf + copied);
+            copied += n;
+            m_offset += n;
+            if (m_offset == static_cast<size_t>(block->size)) {
+                m_ring->Pop();
+                m_offset = 0;
+            }
+            if (copied == count) {
+                break;
+            }
+        }
+        return static_cast<int>(copied);
+    }
+
+    // Discards the data read ahead. The file should be seeked before next Read().
+    void Stop()
+    {
+        if (m_thread.joinable()) {
+            m_ring->Close();
+            m_thread.join();
+        }
+        m_ring->Reset();
+        m_offset = 0;
+    }
+
+private:
+    void Start()
+    {
+        std::shared_ptr<CBlockRing> ring = m_ring;
+        std::function<int (uint8_t *, size_t)> readProc = m_readProc;
+        int cpu = m_cpu;
+        m_thread = std::thread([ring, readProc, cpu]() {
+            if (cpu >= 0) {
+                SetCurrentThreadCpu(cpu);
+            }
+            for (CBlockRing::BLOCK *block; (block = ring->WaitForFree()) != nullptr; ) {
+                block->size = readProc(block->data.data(), block->data.size());
+                ring->Push();
+                if (block->size <= 0) {
+                    break;
+                }
+            }
+        });
+    }
+
+    std::shared_ptr<CBlockRing> m_ring;
+    std::function<int (uint8_t *, size_t)> m_readProc;
+    int m_cpu;
+    bool m_mayBlock;
+    size_t m_offset;
+    std::thread m_thread;
+};
+
+// Writes the output on its own thread.
+class CWriteThread
+{
+public:
+    CWriteThread(size_t blockSize) : m_ring(8, blockSize), m_block(nullptr), m_failed(false), m_writtenBytes(0) {}
+    ~CWriteThread() { Flush(); }
+    bool IsStarted() const { return m_thread.joinable(); }
+    // Returns the number of bytes passed to the stream so far. The rest is still in the ring.
+    int64_t GetWrittenBytes() const { return m_writtenBytes; }
+
+    // If flushWhenIdle is true, the stream is flushed each time the ring becomes empty.
+    void Start(FILE *fp, int cpu, bool flushWhenIdle)
+    {
+        m_thread = std::thread([this, fp, cpu, flushWhenIdle]() {
+            if (cpu >= 0) {
+                SetCurrentThreadCpu(cpu);
+            }
+            for (CBlockRing::BLOCK *block; (block = m_ring.WaitForFilled()) != nullptr; ) {
+                // After failure, just discard
+                if (!m_failed && fwrite(block->data.data(), 1, block->size, fp) != static_cast<size_t>(block->size)) {
+                    m_failed = true;
+                }
+                m_writtenBytes += block->size;
+                m_ring.Pop();
+                if (flushWhenIdle && !m_failed && m_ring.Empty() && fflush(fp) != 0) {
+                    m_failed = true;
+                }
+            }
+            if (fflush(fp) != 0) {
+                m_failed = true;
+            }
+        });
+    }
+
+    // Returns false if this or any previous write failed.
+    bool Write(const uint8_t *data, size_t size)
+    {
+        while (size > 0) {
+            if (!m_block) {
+                m_block = m_ring.WaitForFree();
+                m_block->size = 0;
+            }
+            size_t n = std::min(size, m_block->data.size() - m_block->size);
+            std::copy(data, data + n, m_block->data.begin() + m_block->size);
+            m_block->size += static_cast<int>(n);
+            data += n;
+            size -= n;
+            if (static_cast<size_t>(m_block->size) == m_block->data.size()) {
+                m_block = nullptr;
+                m_ring.Push();
+            }
+        }
+        if (m_block && m_ring.Empty()) {
+            // The thread is idle, so don't wait for the block to fill up
+            Release();
+        }
+        return !m_failed;
+    }
+
+    // Hands the partially filled block to the thread.
+    void Release()
+    {
+        if (m_block) {
+            m_block = nullptr;
+            m_ring.Push();
+        }
+    }
+
+    // Waits for all writes. Returns false if any write failed.
+    bool Flush()
+    {
+        if (m_thread.joinable()) {
+            Release();
+            m_ring.Close();
+            m_thread.join();
+        }
+        return !m_failed;
+    }
+
+private:
+    CBlockRing m_ring;
+    CBlockRing::BLOCK *m_block;
+    std::atomic<bool> m_failed;
+    std::atomic<int64_t> m_writtenBytes;
+    std::thread m_thread;
+};
+
+struct BATCH_JOB
+{
+    int line;
+    std::vector<std::basic_string<ARG_CHAR>> args;
+};
+
+// Splits text[pos, end) into arguments separated by spaces or tabs. Double quotes enclose an argument including spaces.
+template<class T>
+std::vector<std::basic_string<T>> SplitArguments(const std::basic_string<T> &text, size_t pos, size_t end)
+{
+    std::vector<std::basic_string<T>> args;
+    std::basic_string<T> arg;
+    bool hasArg = false;
+    bool quoted = false;
+    for (size_t i = pos; i <= end; ++i) {
+        T c = i < end ? text[i] : T(' ');
+        if (c == T('"')) {
+            quoted = !quoted;
+            hasArg = true;
+        }
+        else if (quoted ? i < end : c != T(' ') && c != T('\t') && c != T('\r')) {
+            arg += c;
+            hasArg = true;
+        }
+        else if (hasArg) {
+            args.push_back(arg);
+            arg.clear();
+            hasArg = false;
+            quoted = false;
+        }
+    }
+    return args;
+}
+
+// Splits the job list into jobs. Each line is a list of arguments. Empty lines and lines beginning with '#' are ignored.
+template<class T>
+std::vector<BATCH_JOB> SplitJobList(const std::basic_string<T> &text)
 {
-    OVERLAPPED ol = {};
-    DWORD nRead;
-    if (asyncContext) {
-        // For asynchronous, returns -1 for EOF
-        ol.hEvent = asyncContext;
-        if (ReadFile(file, buf, static_cast<DWORD>(count), nullptr, &ol)) {
-            return GetOverlappedResult(file, &ol, &nRead, FALSE) ? nRead : -1;
+    std::vector<BATCH_JOB> jobs;
+    int line = 0;
+    for (size_t i = 0; i < text.size();) {
+        size_t lineEnd = std::min(text.find(T('\n'), i), text.size());
+        BATCH_JOB job;
+        job.line = ++line;
+        if (text[i] != T('#')) {
+            job.args = SplitArguments(text, i, lineEnd);
         }
-        else if (GetLastError() == ERROR_IO_PENDING) {
-            while (!asyncCancelProc()) {
-                if (WaitForSingleObject(asyncContext, 1000) != WAIT_TIMEOUT) {
-                    return GetOverlappedResult(file, &ol, &nRead, FALSE) ? nRead : -1;
-                }
-            }
-            CancelIo(file);
-            WaitForSingleObject(asyncContext, INFINITE);
+        if (!job.args.empty()) {
+            jobs.push_back(std::move(job));
         }
+        i = lineEnd + 1;
     }
-    else if (ReadFile(file, buf, static_cast<DWORD>(count), &nRead, nullptr)) {
-        // For synchronous, 0 means EOF
-        return nRead;
-    }
-    return -1;
+    return jobs;
 }
 
-void CloseFile(HANDLE file, HANDLE asyncContext)
+// Reads the job list in UTF-8. "-" means the standard input.
+bool LoadJobList(const ARG_CHAR *name, std::vector<BATCH_JOB> &jobs)
 {
-    if (file != INVALID_HANDLE_VALUE) {
-        CloseHandle(file);
+    bool isStdin = name[0] == '-' && !name[1];
+#ifdef _WIN32
+    FILE *fp = isStdin ? stdin : _wfopen(name, L"rb");
+#else
+    FILE *fp = isStdin ? stdin : fopen(name, "rb");
+#endif
+    if (!fp) {
+        return false;
     }
-    if (asyncContext) {
-        CloseHandle(asyncContext);
+    std::string text;
+    char buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), fp)) != 0; ) {
+        text.append(buf, n);
     }
-}
+    bool failed = ferror(fp) != 0;
+    if (!isStdin) {
+        fclose(fp);
+    }
+    if (failed) {
+        return false;
+    }
+    if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        // BOM
+        text.erase(0, 3);
+    }
+#ifdef _WIN32
+    std::wstring wtext(text.size(), L'\0');
+    if (!text.empty()) {
+        wtext.resize(MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &wtext[0], static_cast<int>(wtext.size())));
+    }
+    jobs = SplitJobList(wtext);
 #else
-const char *GetSmallString(const char *s)
-{
-    return s;
+    jobs = SplitJobList(text);
+#endif
+    return true;
 }
 
-int64_t SeekFile(int file, int64_t offset)
+int RunSession(int argc, const ARG_CHAR *const *argv, bool inBatch);
+
+// Additional service selection and conversion fed by the same input ("-k")
+struct FANOUT_BRANCH
 {
-    return lseek(file, offset < 0 ? offset + 1 : offset, offset < 0 ? SEEK_END : SEEK_SET);
-}
+    FANOUT_BRANCH() : traceName(EMPTY_ARG), outputName(EMPTY_ARG), traceFile(nullptr, fclose), outputFile(nullptr, fclose) {}
+    std::vector<std::basic_string<ARG_CHAR>> args;
+    const ARG_CHAR *traceName;
+    const ARG_CHAR *outputName;
+    std::unique_ptr<FILE, decltype(&fclose)> traceFile;
+    std::unique_ptr<FILE, decltype(&fclose)> outputFile;
+    CServiceFilter servicefilter;
+    CStreamModel model;
+    CTraceB24Caption traceb24;
+    CID3Converter id3conv;
+};
 
-template<class P>
-int ReadFileToBuffer(int file, uint8_t *buf, size_t count, int &asyncContext, P asyncCancelProc)
+// Parses an option of the chain of service selection and conversion. Returns false if invalid.
+bool ParseChainOption(char c, const ARG_CHAR *arg, CServiceFilter &servicefilter, CID3Converter &id3conv,
+                      const ARG_CHAR *&traceName, const ARG_CHAR *&outputName)
 {
-    for (;;) {
-        int ret = static_cast<int>(read(file, buf, count));
-        if (ret >= 0 || !asyncContext || (errno != EAGAIN && errno != EWOULDBLOCK) || asyncCancelProc()) {
-            // Asynchronous FIFO reading can be opened before a writer opens it, then read() returns 0.
-            if (asyncContext && ret > 0) {
-                // Connected.
-                asyncContext = 2;
-            }
-            // For asynchronous, returns -1 for EOF
-            // For synchronous, 0 means EOF
-            return asyncContext == 2 && ret == 0 ? -1 : ret;
+    if (c == 'n') {
+        int n = static_cast<int>(strtol(GetSmallString(arg), nullptr, 10));
+        servicefilter.SetProgramNumberOrIndex(n);
+        return -256 <= n && n <= 65535;
+    }
+    else if (c == 'a' || c == 'b' || c == 'c' || c == 'u') {
+        int mode = static_cast<int>(strtol(GetSmallString(arg), nullptr, 10));
+        if (c == 'a') {
+            servicefilter.SetAudio1Mode(mode);
+            return 0 <= mode && mode <= 13 && mode % 4 <= 1;
         }
-        fd_set rfd;
-        FD_ZERO(&rfd);
-        FD_SET(file, &rfd);
-        timeval tv = {};
-        tv.tv_sec = 1;
-        if (select(file + 1, &rfd, nullptr, nullptr, &tv) < 0) {
-            return -1;
+        else if (c == 'b') {
+            servicefilter.SetAudio2Mode(mode);
+            return 0 <= mode && mode <= 7 && mode % 4 <= 3;
+        }
+        else if (c == 'c') {
+            servicefilter.SetCaptionMode(mode);
+        }
+        else {
+            servicefilter.SetSuperimposeMode(mode);
         }
+        return 0 <= mode && mode <= 6 && mode % 4 <= 2;
+    }
+    else if (c == 'r') {
+        traceName = arg;
+    }
+    else if (c == 'o') {
+        outputName = arg;
+        return !!outputName[0];
+    }
+    else if (c == 'd') {
+        id3conv.SetOption(static_cast<int>(strtol(GetSmallString(arg), nullptr, 10)));
     }
+    return true;
 }
 
-void CloseFile(int file, int asyncContext)
+// Runs the jobs on "workers" threads. Each job is a session with "defaultArgs" followed by the arguments of the job.
+int RunBatch(int workers, const ARG_CHAR *jobListName, const std::vector<const ARG_CHAR *> &defaultArgs)
 {
-    static_cast<void>(asyncContext);
-    if (file >= 0) {
-        close(file);
+    std::vector<BATCH_JOB> jobs;
+    if (!LoadJobList(jobListName, jobs)) {
+        fprintf(stderr, "Error: cannot read job list.\n");
+        return 1;
     }
-}
-#endif
+    std::atomic<size_t> nextJob(0);
+    std::atomic<int> failedCount(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers && static_cast<size_t>(i) < jobs.size(); ++i) {
+        threads.emplace_back([&]() {
+            for (size_t j; (j = nextJob++) < jobs.size(); ) {
+                std::vector<const ARG_CHAR *> args(defaultArgs);
+                for (auto it = jobs[j].args.begin(); it != jobs[j].args.end(); ++it) {
+                    args.push_back(it->c_str());
+                }
+                if (RunSession(static_cast<int>(args.size()), args.data(), true) != 0) {
+                    fprintf(stderr, "Warning: job at line %d failed.\n", jobs[j].line);
+                    ++failedCount;
+                }
+            }
+        });
+    }
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+        it->join();
+    }
+    return failedCount != 0;
 }
 
-#ifdef _WIN32
-int wmain(int argc, wchar_t **argv)
-#else
-int main(int argc, char **argv)
-#endif
+// Processes one input. All state is local, so that sessions can run concurrently in batch mode.
+int RunSession(int argc, const ARG_CHAR *const *argv, bool inBatch)
 {
     int64_t seekOffset = 0;
+    int seekSec = 0;
+    int rangeSec = 0;
+    int ioFlags = 0;
+    int pinCpu = -1;
+    int writeSizeKbytes = 0;
     int limitReadBytesPerSec = 0;
+    int latencyMsec = 0;
     int timeoutSec = 0;
     int timeoutMode = 0;
-    std::unordered_set<int> excludePidSet;
+    int batchWorkers = 0;
+    int batchArgIndex = 0;
+    std::vector<uint8_t> excludePids(8192, 0);
+    std::vector<std::unique_ptr<FANOUT_BRANCH>> branches;
     std::unique_ptr<FILE, decltype(&fclose)> traceFile(nullptr, fclose);
+    std::unique_ptr<FILE, decltype(&fclose)> outputFile(nullptr, fclose);
     CServiceFilter servicefilter;
     CTraceB24Caption traceb24;
     CID3Converter id3conv;
+    CPcrPacer pacer;
 #ifdef _WIN32
     const wchar_t *srcName = L"";
     const wchar_t *traceName = L"";
+    const wchar_t *outputName = L"";
+    const wchar_t *indexName = L"";
 #else
     const char *srcName = "";
     const char *traceName = "";
+    const char *outputName = "";
+    const char *indexName = "";
 #endif
 
     for (int i = 1; i < argc; ++i) {
@@ -172,7 +1688,7 @@ int main(int argc, char **argv)
             c = ss[1];
         }
         if (c == 'h') {
-            fprintf(stderr, "Usage: tsreadex [-z ignored][-s seek][-l limit][-t timeout][-m mode][-x pids][-n prog_num_or_index][-a aud1][-b aud2][-c cap][-u sup][-r trace][-d flags] src\n");
+            fprintf(stderr, "Usage: tsreadex [-z ignored][-s seek][-g seek_sec][-q range_sec][-i flags][-p cpu][-l limit][-e pace][-f latency][-t timeout][-m mode][-x pids][-n prog_num_or_index][-a aud1][-b aud2][-c cap][-u sup][-r trace][-o output][-w wsize][-y index][-d flags][-k branch][-j workers] src\n");
             return 2;
         }
         bool invalid = false;
@@ -183,10 +1699,35 @@ int main(int argc, char **argv)
             else if (c == 's') {
                 seekOffset = strtoll(GetSmallString(argv[++i]), nullptr, 10);
             }
+            else if (c == 'g') {
+                seekSec = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= seekSec && seekSec <= 86400);
+            }
+            else if (c == 'q') {
+                rangeSec = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= rangeSec && rangeSec <= 86400);
+            }
+            else if (c == 'i') {
+                ioFlags = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= ioFlags && ioFlags <= 15);
+            }
+            else if (c == 'p') {
+                pinCpu = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(-1 <= pinCpu && pinCpu <= 255);
+            }
             else if (c == 'l') {
                 limitReadBytesPerSec = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10) * 1024);
                 invalid = !(0 <= limitReadBytesPerSec && limitReadBytesPerSec <= 32 * 1024 * 1024);
             }
+            else if (c == 'f') {
+                latencyMsec = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= latencyMsec && latencyMsec <= 10000);
+            }
+            else if (c == 'e') {
+                int pace = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= pace && pace <= 10000);
+                pacer.SetSpeed(pace);
+            }
             else if (c == 't') {
                 timeoutSec = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
                 invalid = !(0 <= timeoutSec && timeoutSec <= 600);
@@ -196,50 +1737,54 @@ int main(int argc, char **argv)
                 invalid = !(0 <= timeoutMode && timeoutMode <= 2);
             }
             else if (c == 'x') {
-                excludePidSet.clear();
+                std::fill(excludePids.begin(), excludePids.end(), 0);
                 ++i;
                 for (size_t j = 0; argv[i][j];) {
                     ss = GetSmallString(argv[i] + j);
                     char *endp;
                     int pid = static_cast<int>(strtol(ss, &endp, 10));
-                    excludePidSet.emplace(pid);
                     invalid = !(0 <= pid && pid <= 8191 && ss != endp && (!*endp || *endp == '/'));
-                    if (invalid || !*endp) {
+                    if (invalid) {
+                        break;
+                    }
+                    excludePids[pid] = 1;
+                    if (!*endp) {
                         break;
                     }
                     j += endp - ss + 1;
                 }
             }
-            else if (c == 'n') {
-                int n = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
-                invalid = !(-256 <= n && n <= 65535);
-                servicefilter.SetProgramNumberOrIndex(n);
+            else if (c == 'n' || c == 'a' || c == 'b' || c == 'c' || c == 'u' || c == 'r' || c == 'o' || c == 'd') {
+                invalid = !ParseChainOption(c, argv[++i], servicefilter, id3conv, traceName, outputName);
             }
-            else if (c == 'a' || c == 'b' || c == 'c' || c == 'u') {
-                int mode = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
-                if (c == 'a') {
-                    invalid = !(0 <= mode && mode <= 13 && mode % 4 <= 1);
-                    servicefilter.SetAudio1Mode(mode);
-                }
-                else if (c == 'b') {
-                    invalid = !(0 <= mode && mode <= 7 && mode % 4 <= 3);
-                    servicefilter.SetAudio2Mode(mode);
-                }
-                else {
-                    invalid = !(0 <= mode && mode <= 6 && mode % 4 <= 2);
-                    if (c == 'c') {
-                        servicefilter.SetCaptionMode(mode);
-                    }
-                    else {
-                        servicefilter.SetSuperimposeMode(mode);
-                    }
-                }
+            else if (c == 'y') {
+                indexName = argv[++i];
+                invalid = !indexName[0];
             }
-            else if (c == 'r') {
-                traceName = argv[++i];
+            else if (c == 'w') {
+                writeSizeKbytes = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = !(0 <= writeSizeKbytes && writeSizeKbytes <= 4096);
             }
-            else if (c == 'd') {
-                id3conv.SetOption(static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10)));
+            else if (c == 'k') {
+                std::unique_ptr<FANOUT_BRANCH> branch(new FANOUT_BRANCH);
+                std::basic_string<ARG_CHAR> options = argv[++i];
+                branch->args = SplitArguments(options, 0, options.size());
+                for (size_t j = 0; !invalid && j < branch->args.size(); j += 2) {
+                    ss = GetSmallString(branch->args[j].c_str());
+                    char bc = ss[0] == '-' && ss[1] && !ss[2] ? ss[1] : '\0';
+                    invalid = !(bc == 'n' || bc == 'a' || bc == 'b' || bc == 'c' || bc == 'u' || bc == 'r' || bc == 'o' || bc == 'd') ||
+                              j + 1 >= branch->args.size() ||
+                              !ParseChainOption(bc, branch->args[j + 1].c_str(), branch->servicefilter, branch->id3conv,
+                                                branch->traceName, branch->outputName);
+                }
+                // Standard output is for the main chain
+                invalid = invalid || !branch->outputName[0] || (branch->traceName[0] == '-' && !branch->traceName[1]);
+                branches.push_back(std::move(branch));
+            }
+            else if (c == 'j') {
+                batchArgIndex = i;
+                batchWorkers = static_cast<int>(strtol(GetSmallString(argv[++i]), nullptr, 10));
+                invalid = inBatch || !(1 <= batchWorkers && batchWorkers <= 64);
             }
         }
         else {
@@ -260,14 +1805,40 @@ int main(int argc, char **argv)
             fprintf(stderr, "Error: timeout must not be 0 in non-blocking mode.\n");
             return 1;
         }
-        if (seekOffset != 0) {
+        if (seekOffset != 0 || seekSec != 0) {
             fprintf(stderr, "Error: cannot seek file in non-blocking mode.\n");
+            if (seekSec != 0) {
+                return 1;
+            }
+        }
+    }
+    if (seekOffset != 0 && seekSec != 0) {
+        fprintf(stderr, "Error: cannot seek by both offset and time.\n");
+        return 1;
+    }
+    if (batchWorkers != 0) {
+        if (pinCpu >= 0 || outputName[0]) {
+            // All jobs would be pinned to the same CPUs or write the same file
+            fprintf(stderr, "Error: cannot use -p or -o as defaults in batch mode.\n");
+            return 1;
         }
+        // The other options are the defaults for each job, and src is the job list
+        std::vector<const ARG_CHAR *> defaultArgs;
+        for (int i = 0; i < argc - 1; ++i) {
+            if (i != batchArgIndex && i != batchArgIndex + 1) {
+                defaultArgs.push_back(argv[i]);
+            }
+        }
+        return RunBatch(batchWorkers, srcName, defaultArgs);
+    }
+    if (inBatch && ((srcName[0] == '-' && !srcName[1]) || (traceName[0] == '-' && !traceName[1]))) {
+        fprintf(stderr, "Error: cannot use standard input/output in batch mode.\n");
+        return 1;
     }
 
 #ifdef _WIN32
     bool traceToStdout = traceName[0] == L'-' && !traceName[1];
-    if (!traceToStdout && _setmode(_fileno(stdout), _O_BINARY) < 0) {
+    if (!traceToStdout && !inBatch && _setmode(_fileno(stdout), _O_BINARY) < 0) {
         fprintf(stderr, "Error: _setmode.\n");
         return 1;
     }
@@ -303,6 +1874,9 @@ int main(int argc, char **argv)
             fprintf(stderr, "Warning: cannot open tracefile.\n");
         }
     }
+    if (outputName[0]) {
+        outputFile.reset(_wfopen(outputName, L"wb"));
+    }
 #else
     bool traceToStdout = traceName[0] == '-' && !traceName[1];
     // 0: synchronous, 1: not connected yet, 2: connected.
@@ -331,33 +1905,302 @@ int main(int argc, char **argv)
             fprintf(stderr, "Warning: cannot open tracefile.\n");
         }
     }
+    if (outputName[0]) {
+        outputFile.reset(OpenOutputFile(outputName));
+    }
 #endif
     traceb24.SetFile(traceToStdout ? stdout : traceFile.get());
 
+    // Output of TS packets, or nullptr if suppressed
+    FILE *output = outputName[0] ? outputFile.get() : traceToStdout || inBatch ? nullptr : stdout;
+    if (outputName[0] && !output) {
+        fprintf(stderr, "Error: cannot open output.\n");
+        CloseFile(openedFile, asyncContext);
+        return 1;
+    }
+    // Round down to whole packets
+    size_t writeSize = writeSizeKbytes * 1024 / 188 * 188;
+    if (output && writeSize != 0) {
+        setvbuf(output, nullptr, _IOFBF, writeSize);
+    }
+    // The input is modeled once for all chains
+    CStreamModel inputModel;
+    servicefilter.SetStreamModel(&inputModel);
+    CStreamModel outputModel;
+    traceb24.SetStreamModel(&outputModel);
+    id3conv.SetStreamModel(&outputModel);
+    for (auto it = branches.begin(); it != branches.end(); ++it) {
+        FANOUT_BRANCH &branch = **it;
+#ifdef _WIN32
+        if (branch.traceName[0]) {
+            branch.traceFile.reset(_wfopen(branch.traceName, L"w"));
+        }
+        branch.outputFile.reset(_wfopen(branch.outputName, L"wb"));
+#else
+        if (branch.traceName[0]) {
+            branch.traceFile.reset(fopen(branch.traceName, "w"));
+        }
+        branch.outputFile.reset(OpenOutputFile(branch.outputName));
+#endif
+        if (branch.traceName[0] && !branch.traceFile) {
+            fprintf(stderr, "Warning: cannot open tracefile.\n");
+        }
+        if (!branch.outputFile) {
+            fprintf(stderr, "Error: cannot open output.\n");
+            CloseFile(openedFile, asyncContext);
+            return 1;
+        }
+        if (writeSize != 0) {
+            setvbuf(branch.outputFile.get(), nullptr, _IOFBF, writeSize);
+        }
+        branch.traceb24.SetFile(branch.traceFile.get());
+        branch.servicefilter.SetStreamModel(&inputModel);
+        branch.traceb24.SetStreamModel(&branch.model);
+        branch.id3conv.SetStreamModel(&branch.model);
+    }
+#ifdef __linux__
+    CWritebackControl writeback;
+    if (outputName[0]) {
+        writeback.Open(fileno(output));
+    }
+    // Bytes of the write thread already notified to the writeback
+    int64_t writebackThreadBytes = 0;
+#endif
+
+    auto readAt = [file](int64_t pos, uint8_t *p, size_t count) -> int {
+        decltype(asyncContext) syncContext = 0;
+        return SeekFile(file, pos) != pos ? -1 : ReadFileToBuffer(file, p, count, syncContext, []() { return std::chrono::seconds(0); });
+    };
+    // Use the index if it is for this input, otherwise build it when reading from the beginning
+    CTsIndex index;
+    bool indexLoaded = false;
+    bool indexBuilding = false;
+    if (indexName[0]) {
+        int64_t fileSize = timeoutMode == 2 ? -1 : SeekFile(file, -1);
+        if (fileSize >= 0) {
+#ifdef _WIN32
+            std::unique_ptr<FILE, decltype(&fclose)> indexFile(_wfopen(indexName, L"rb"), fclose);
+#else
+            std::unique_ptr<FILE, decltype(&fclose)> indexFile(fopen(indexName, "rb"), fclose);
+#endif
+            indexLoaded = indexFile && index.Load(indexFile.get(), fileSize);
+            if (SeekFile(file, 0) != 0) {
+                fprintf(stderr, "Error: seek failed.\n");
+                CloseFile(openedFile, asyncContext);
+                return 1;
+            }
+        }
+        indexBuilding = !indexLoaded && seekOffset == 0 && seekSec == 0;
+    }
+
+    // Find the offset of the time to seek, before any reader starts
+    int rangePcrPid = -1;
+    int64_t rangeBasePcr = -1;
+    // Copies of PAT/PMT packets to be processed before the seek position
+    std::vector<uint8_t> primeBuf;
+    if (seekSec != 0) {
+        int64_t offset = -1;
+        if (indexLoaded) {
+            offset = index.FindSeekOffset(seekSec, rangePcrPid, rangeBasePcr);
+            std::vector<CTsIndex::RECORD> psiRecords = index.GetPsiRecords(offset);
+            std::vector<uint8_t> window(65536);
+            for (auto it = psiRecords.begin(); offset > 0 && it != psiRecords.end(); ++it) {
+                int n = readAt(it->offset, window.data(), window.size());
+                int unitSize = 0;
+                int bufPos = n > 0 ? resync_ts(window.data(), n, &unitSize) : 0;
+                // Copy until the next section begins. Sections longer than this are rare.
+                int count = 0;
+                for (int i = bufPos; unitSize != 0 && i + unitSize <= n && count < 8; i += unitSize) {
+                    const uint8_t *packet = &window[i];
+                    if (extract_ts_header_pid(packet) == it->pid) {
+                        bool unitStart = !!extract_ts_header_unit_start(packet);
+                        if (count != 0 && unitStart) {
+                            break;
+                        }
+                        if (count != 0 || unitStart) {
+                            primeBuf.insert(primeBuf.end(), packet, packet + 188);
+                            ++count;
+                        }
+                    }
+                }
+            }
+        }
+        else {
+            int64_t fileSize = SeekFile(file, -1);
+            offset = fileSize < 0 ? -1 : SearchPcrOffset(readAt, fileSize, seekSec, rangePcrPid, rangeBasePcr);
+        }
+        if (offset < 0 || SeekFile(file, 0) != 0) {
+            fprintf(stderr, "Error: seek failed.\n");
+            CloseFile(openedFile, asyncContext);
+            return 1;
+        }
+        seekOffset = offset;
+    }
+    CPcrRangeEnd rangeEnd(rangeSec, rangePcrPid, rangeBasePcr);
+
+#ifdef _WIN32
+    bool mapped = false;
+#else
+    CMappedFile mappedFile;
+    bool mapped = (ioFlags & (1 | 8)) && !asyncContext && mappedFile.Open(file);
+#endif
+#ifdef __linux__
+    CSpliceWriter spliceWriter;
+    if (ioFlags & 8) {
+        // Larger pipes need fewer wakeups. Just fails for non-pipes.
+        fcntl(file, F_SETPIPE_SZ, PIPE_SIZE_FOR_SPLICE);
+        if (mapped && output) {
+            spliceWriter.Open(file, fileno(output));
+        }
+    }
+    CUringIo uring;
+    if (ioFlags & 2) {
+        uring.Open(mapped || asyncContext ? -1 : file, !output || spliceWriter.IsOpen() ? -1 : fileno(output));
+    }
+#endif
+    // Reading, processing and writing threads are pinned to pinCpu, pinCpu+1 and pinCpu+2 respectively
+    CReadThread readThread;
+    CWriteThread writeThread(writeSize != 0 ? writeSize : 65536 / 188 * 188);
+    if (ioFlags & 4) {
+        bool uringReading = false;
+        bool uringOrSpliceWriting = false;
+#ifdef __linux__
+        uringReading = uring.IsReading();
+        uringOrSpliceWriting = uring.IsWriting() || spliceWriter.IsOpen();
+#endif
+        // Reading ahead would bypass the limit of the reading rate
+        if (!mapped && !uringReading && !asyncContext && limitReadBytesPerSec == 0) {
+            // Reading other than a regular file may outlive the session, so it uses a duplicate that it closes itself
+            bool mayBlock = !IsRegularFile(file);
+            decltype(file) readFile = file;
+            if (!mayBlock || DuplicateFile(file, readFile)) {
+                std::shared_ptr<decltype(file)> duplicated;
+                if (mayBlock) {
+                    duplicated.reset(new decltype(file)(readFile), [](decltype(file) *p) { CloseFile(*p, 0); delete p; });
+                }
+                readThread.Enable([readFile, duplicated](uint8_t *p, size_t count) -> int {
+                    decltype(asyncContext) syncContext = 0;
+                    return ReadFileToBuffer(readFile, p, count, syncContext, []() { return std::chrono::seconds(0); });
+                }, pinCpu, mayBlock);
+            }
+        }
+        if (!uringOrSpliceWriting && output) {
+            // Paced output must not be held in the stream while waiting
+            writeThread.Start(output, pinCpu < 0 ? -1 : pinCpu + 2, latencyMsec != 0 || pacer.IsEnabled());
+        }
+    }
+    if (pinCpu >= 0) {
+        SetCurrentThreadCpu((ioFlags & 4) ? pinCpu + 1 : pinCpu);
+    }
+
+#ifdef __linux__
+    CInputWaiter inputWaiter;
+    if (timeoutSec != 0) {
+        inputWaiter.Open(file);
+    }
+#endif
+
+    auto seekInput = [&](int64_t offset) -> int64_t {
+#ifndef _WIN32
+        if (mapped) {
+            return mappedFile.Seek(offset);
+        }
+#endif
+#ifdef __linux__
+        if (uring.IsReading()) {
+            return uring.Seek(offset);
+        }
+#endif
+        if (readThread.IsEnabled()) {
+            readThread.Stop();
+        }
+        return SeekFile(file, offset);
+    };
+
     int64_t filePos = 0;
     if (seekOffset != 0) {
-        filePos = SeekFile(file, seekOffset);
+        filePos = seekInput(seekOffset);
         if (filePos < 0) {
             fprintf(stderr, "Error: seek failed.\n");
+            readThread.Close();
             CloseFile(openedFile, asyncContext);
             return 1;
         }
     }
 
-    static uint8_t buf[65536];
+    const size_t READ_BUF_SIZE = 65536;
+    std::unique_ptr<uint8_t[]> readBufHolder(new uint8_t[READ_BUF_SIZE]);
+    uint8_t *readBuf = readBufHolder.get();
+    // Points to readBuf, or into the mapped file
+    const uint8_t *buf = readBuf;
     int bufCount = 0;
     int unitSize = 0;
-    size_t bufSize = sizeof(buf) / 8;
+    size_t bufSize = READ_BUF_SIZE / 8;
     int measurementReadCount = 0;
     auto lastWriteTime = std::chrono::steady_clock::now();
     auto lastMeasurementTime = lastWriteTime;
-    auto limitReadTime = lastWriteTime + std::chrono::seconds(1);
+    // Allow bursts of 100 msec, but at least one full read
+    CTokenBucket limitReadBucket(limitReadBytesPerSec, std::max<int64_t>(limitReadBytesPerSec / 10, READ_BUF_SIZE));
     int64_t limitReadFilePos = filePos;
+
+    // Headers of the packets being processed, decoded once for all stages
+    TS_HEADERS inputHeaders;
+    TS_HEADERS outputHeaders;
+    auto decodePackets = [](TS_HEADERS &headers, const CPacketList &packets) {
+        headers.packet.clear();
+        packets.ForEach([&](const uint8_t *packet) { headers.packet.push_back(packet); });
+        decode_ts_headers(&headers);
+    };
+
+    // Passes the packet to the service filters. Priming packets are only for the filters selecting a service.
+    auto dispatchPacket = [&](size_t index, bool priming) {
+        int pid = inputHeaders.pid[index];
+        if (!excludePids[pid]) {
+            inputModel.AddPacket(inputHeaders, index);
+            if (!priming || servicefilter.GetProgramNumberOrIndex() != 0) {
+                servicefilter.AddPacket(inputHeaders, index);
+            }
+            for (auto it = branches.begin(); it != branches.end(); ++it) {
+                if (!priming || (*it)->servicefilter.GetProgramNumberOrIndex() != 0) {
+                    (*it)->servicefilter.AddPacket(inputHeaders, index);
+                }
+            }
+        }
+    };
+    // The output refers to primeBuf until the first writing
+    for (size_t i = 0; i < primeBuf.size(); i += 188) {
+        inputHeaders.packet.push_back(&primeBuf[i]);
+    }
+    decode_ts_headers(&inputHeaders);
+    for (size_t i = 0; i < inputHeaders.packet.size(); ++i) {
+        dispatchPacket(i, true);
+    }
+    CLatencyTarget latencyTarget(latencyMsec);
+    CTsSyncTracker syncTracker;
+    int64_t latencyFilePos = filePos;
     for (;;) {
         // If timeoutMode == 1, read between "next to the syncword (buf[0])" and syncword.
         size_t bufMax = unitSize == 0 ? bufSize : bufSize / unitSize * unitSize - (timeoutMode == 1 ? unitSize - 1 : 0);
-        int n = ReadFileToBuffer(file, buf + bufCount, bufMax - bufCount, asyncContext, [=]() {
-                    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - lastWriteTime).count() >= timeoutSec; });
+        int n;
+#ifndef _WIN32
+        if (mapped) {
+            n = mappedFile.Read(bufMax - bufCount, bufCount, buf);
+        }
+        else
+#endif
+#ifdef __linux__
+        if (uring.IsReading()) {
+            n = uring.Read(readBuf + bufCount, bufMax - bufCount);
+        }
+        else
+#endif
+        if (readThread.IsEnabled()) {
+            n = readThread.Read(readBuf + bufCount, bufMax - bufCount);
+        }
+        else {
+            n = ReadFileToBuffer(file, readBuf + bufCount, bufMax - bufCount, asyncContext, [&]() {
+                    return latencyTarget.GetRemaining(lastWriteTime + std::chrono::seconds(timeoutSec) - std::chrono::steady_clock::now()); });
+        }
         bool retry = false;
         bool completed = false;
         int bufPos = -1;
@@ -388,10 +2231,15 @@ int main(int argc, char **argv)
                         else {
                             // Keep bufPos always 0
                             filePos += bufPos + 1;
-                            buf[0] = buf[bufPos];
+                            if (mapped) {
+                                buf += bufPos;
+                            }
+                            else {
+                                readBuf[0] = readBuf[bufPos];
+                            }
                             bufCount = 1;
                             bufPos = 0;
-                            if (SeekFile(file, filePos) != filePos) {
+                            if (seekInput(filePos) != filePos) {
                                 fprintf(stderr, "Warning: seek failed.\n");
                                 completed = true;
                             }
@@ -415,7 +2263,8 @@ int main(int argc, char **argv)
         else {
             // Asynchronous, pipe
             if (n < 0) {
-                completed = true;
+                // Reading may have been canceled to process pending packets
+                completed = !latencyTarget.IsExpired();
             }
 #ifndef _WIN32
             else if (n <= 0) {
@@ -427,51 +2276,185 @@ int main(int argc, char **argv)
                 filePos += n;
             }
         }
+        // The deadline is not applied to timeoutMode == 1, which needs the syncword following the buffer
+        latencyTarget.Update(timeoutMode != 1 && bufCount >= (unitSize != 0 ? unitSize : 188 * 8));
 
         if (retry) {
-            if (timeoutSec == 0 ||
-                std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - lastWriteTime).count() >= timeoutSec) {
+            auto remaining = lastWriteTime + std::chrono::seconds(timeoutSec) - std::chrono::steady_clock::now();
+            if (timeoutSec == 0 || remaining <= std::chrono::steady_clock::duration::zero()) {
                 completed = true;
             }
             else {
-                SleepFor(std::chrono::milliseconds(200));
-                if (timeoutMode != 2 && SeekFile(file, filePos) != filePos) {
+                auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(latencyTarget.GetRemaining(remaining)) + std::chrono::milliseconds(1);
+#ifdef __linux__
+                if (!inputWaiter.Wait(waitTime))
+#endif
+                {
+                    SleepFor(std::min(waitTime, std::chrono::milliseconds(200)));
+                }
+                if (timeoutMode != 2 && seekInput(filePos) != filePos) {
                     fprintf(stderr, "Warning: seek failed.\n");
                     completed = true;
                 }
             }
         }
 
-        if (bufCount == static_cast<int>(bufMax) || completed) {
-            if (bufPos < 0) {
-                bufPos = resync_ts(buf, bufCount, &unitSize);
+        if (bufCount == static_cast<int>(bufMax) || completed || latencyTarget.IsExpired()) {
+            latencyTarget.Update(false);
+            // Unless the position is fixed by timeoutMode == 1, follow the sync bytes packet by packet
+            bool tracking = bufPos < 0;
+            int i = tracking ? 0 : bufPos;
+            inputHeaders.packet.clear();
+            for (; tracking ? syncTracker.Next(buf, bufCount, i, unitSize, completed) : unitSize != 0 && i + unitSize <= bufCount; i += unitSize) {
+                inputHeaders.packet.push_back(buf + i);
             }
-            for (int i = bufPos; unitSize != 0 && i + unitSize <= bufCount; i += unitSize) {
-                if (excludePidSet.count(extract_ts_header_pid(buf + i)) == 0) {
-                    servicefilter.AddPacket(buf + i);
+            decode_ts_headers(&inputHeaders);
+            for (size_t j = 0; j < inputHeaders.packet.size(); ++j) {
+                if (rangeEnd.IsEnabled() && rangeEnd.IsPassed(inputHeaders, j)) {
+                    completed = true;
+                    break;
+                }
+                if (indexBuilding) {
+                    index.AddPacket(inputHeaders, j, filePos - bufCount + (inputHeaders.packet[j] - buf));
                 }
+                dispatchPacket(j, false);
             }
-            for (auto it = servicefilter.GetPackets().cbegin(); it != servicefilter.GetPackets().end(); it += 188) {
-                traceb24.AddPacket(&*it);
-                id3conv.AddPacket(&*it);
+            decodePackets(outputHeaders, servicefilter.GetPackets());
+            for (size_t j = 0; j < outputHeaders.packet.size(); ++j) {
+                outputModel.AddPacket(outputHeaders, j);
+                traceb24.AddPacket(outputHeaders, j);
+                id3conv.AddPacket(outputHeaders, j);
+            }
+            for (auto it = branches.begin(); it != branches.end(); ++it) {
+                FANOUT_BRANCH &branch = **it;
+                decodePackets(outputHeaders, branch.servicefilter.GetPackets());
+                for (size_t j = 0; j < outputHeaders.packet.size(); ++j) {
+                    branch.model.AddPacket(outputHeaders, j);
+                    branch.traceb24.AddPacket(outputHeaders, j);
+                    branch.id3conv.AddPacket(outputHeaders, j);
+                }
+                if (!branch.id3conv.GetPackets().Empty()) {
+                    bool writeFailed = false;
+                    branch.id3conv.GetPackets().ForEachRun([&](const uint8_t *data, size_t size) {
+                        writeFailed = writeFailed || fwrite(data, 1, size, branch.outputFile.get()) != size;
+                    });
+                    if (!writeFailed && latencyTarget.IsEnabled()) {
+                        writeFailed = fflush(branch.outputFile.get()) != 0;
+                    }
+                    if (writeFailed) {
+                        completed = true;
+                    }
+                    branch.id3conv.ClearPackets();
+                    lastWriteTime = std::chrono::steady_clock::now();
+                }
             }
-            servicefilter.ClearPackets();
 
             auto nowTime = std::chrono::steady_clock::now();
-            if (++measurementReadCount >= 500) {
+            if (latencyTarget.IsEnabled()) {
+                // Grow only as much as the throughput needs
+                bufSize = latencyTarget.GetReadSize(bufSize, READ_BUF_SIZE / 8, READ_BUF_SIZE, filePos - latencyFilePos);
+                latencyFilePos = filePos;
+            }
+            else if (++measurementReadCount >= 500) {
                 // Maximize buffer size
-                bufSize = sizeof(buf);
+                bufSize = READ_BUF_SIZE;
             }
-            if (std::chrono::duration_cast<std::chrono::seconds>(nowTime - lastMeasurementTime).count() >= 1) {
+            if (!latencyTarget.IsEnabled() &&
+                std::chrono::duration_cast<std::chrono::seconds>(nowTime - lastMeasurementTime).count() >= 1) {
                 // Decrease/Increase buffer size
-                bufSize = measurementReadCount < 10 ? std::max(bufSize - sizeof(buf) / 8, sizeof(buf) / 8) :
-                                                      std::min(bufSize + sizeof(buf) / 8, sizeof(buf));
+                bufSize = measurementReadCount < 10 ? std::max(bufSize - READ_BUF_SIZE / 8, READ_BUF_SIZE / 8) :
+                                                      std::min(bufSize + READ_BUF_SIZE / 8, READ_BUF_SIZE);
                 measurementReadCount = 0;
                 lastMeasurementTime = nowTime;
             }
-            if (!id3conv.GetPackets().empty()) {
-                if (!traceToStdout) {
-                    if (fwrite(id3conv.GetPackets().data(), 1, id3conv.GetPackets().size(), stdout) != id3conv.GetPackets().size()) {
+            if (!id3conv.GetPackets().Empty()) {
+                if (output) {
+                    bool writeFailed = false;
+                    size_t writtenBytes = 0;
+                    auto writeRun = [&](const uint8_t *data, size_t size) {
+                        if (!writeFailed) {
+#ifdef __linux__
+                            if (spliceWriter.IsOpen()) {
+                                writeFailed = !spliceWriter.Write(data, size, mappedFile.GetOffset(data, size));
+                                return;
+                            }
+                            if (uring.IsWriting()) {
+                                writeFailed = !uring.Write(data, size);
+                                return;
+                            }
+#endif
+                            if (writeThread.IsStarted()) {
+                                writeFailed = !writeThread.Write(data, size);
+                                return;
+                            }
+                            writeFailed = fwrite(data, 1, size, output) != size;
+                        }
+                        writtenBytes += size;
+                    };
+                    if (pacer.IsEnabled()) {
+                        const uint8_t *runData = nullptr;
+                        size_t runSize = 0;
+                        decodePackets(outputHeaders, id3conv.GetPackets());
+                        for (size_t j = 0; j < outputHeaders.packet.size(); ++j) {
+                            const uint8_t *packet = outputHeaders.packet[j];
+                            std::chrono::milliseconds waitTime = pacer.AddPacket(outputHeaders, j);
+                            if (waitTime.count() > 0 && runSize != 0) {
+                                // Release the preceding packets before waiting
+                                writeRun(runData, runSize);
+                                runSize = 0;
+#ifdef __linux__
+                                if (!writeFailed && spliceWriter.IsOpen()) {
+                                    writeFailed = !spliceWriter.Flush();
+                                }
+#endif
+                                if (!writeFailed) {
+                                    if (writeThread.IsStarted()) {
+                                        // Flushed by the thread when the ring becomes empty
+                                        writeThread.Release();
+                                    }
+                                    else {
+                                        fflush(output);
+                                    }
+                                }
+                            }
+                            if (waitTime.count() > 0 && !writeFailed) {
+                                SleepFor(waitTime);
+                            }
+                            if (runSize != 0 && runData + runSize != packet) {
+                                writeRun(runData, runSize);
+                                runSize = 0;
+                            }
+                            if (runSize == 0) {
+                                runData = packet;
+                            }
+                            runSize += 188;
+                        }
+                        if (runSize != 0) {
+                            writeRun(runData, runSize);
+                        }
+                    }
+                    else {
+                        id3conv.GetPackets().ForEachRun(writeRun);
+                    }
+#ifdef __linux__
+                    if (!writeFailed && spliceWriter.IsOpen()) {
+                        writeFailed = !spliceWriter.Flush();
+                    }
+                    if (writeThread.IsStarted()) {
+                        // The ring may hold more than SYNC_STEP, so follow what the thread has written
+                        int64_t threadBytes = writeThread.GetWrittenBytes();
+                        writeback.Advance(static_cast<size_t>(threadBytes - writebackThreadBytes));
+                        writebackThreadBytes = threadBytes;
+                    }
+                    else {
+                        writeback.Advance(writtenBytes);
+                    }
+#endif
+                    if (!writeFailed && latencyTarget.IsEnabled() && !writeThread.IsStarted()) {
+                        // Don't leave the packets in the stream buffer
+                        writeFailed = fflush(output) != 0;
+                    }
+                    if (writeFailed) {
                         completed = true;
                     }
                 }
@@ -482,36 +2465,68 @@ int main(int argc, char **argv)
                      std::chrono::duration_cast<std::chrono::seconds>(nowTime - lastWriteTime).count() >= timeoutSec) {
                 completed = true;
             }
+            // Packets may refer to the servicefilter's output, so clear it after writing
+            servicefilter.ClearPackets();
+            for (auto it = branches.begin(); it != branches.end(); ++it) {
+                (*it)->servicefilter.ClearPackets();
+            }
             if (completed) {
                 break;
             }
-            if (unitSize == 0) {
-                bufCount = 0;
+            // Keep the bytes from "i"
+            if (mapped) {
+                // No need to copy, the remaining bytes are still mapped
+                buf += i;
             }
-            else {
-                if ((bufPos != 0 || bufCount >= unitSize) && (bufCount - bufPos) % unitSize != 0) {
-                    std::copy(buf + bufPos + (bufCount - bufPos) / unitSize * unitSize, buf + bufCount, buf);
-                }
-                bufCount = (bufCount - bufPos) % unitSize;
+            else if (i != 0 && i < bufCount) {
+                std::copy(readBuf + i, readBuf + bufCount, readBuf);
             }
+            bufCount -= i;
         }
 
         if (limitReadBytesPerSec != 0) {
-            if (filePos - limitReadFilePos > limitReadBytesPerSec) {
+            auto waitTime = limitReadBucket.Consume(std::max<int64_t>(filePos - limitReadFilePos, 0));
+            limitReadFilePos = filePos;
+            if (waitTime.count() > 0) {
                 // Too fast
-                auto nowTime = std::chrono::steady_clock::now();
-                if (limitReadTime > nowTime) {
-                    SleepFor(std::chrono::duration_cast<std::chrono::milliseconds>(limitReadTime - nowTime));
-                }
-            }
-            auto nowTime = std::chrono::steady_clock::now();
-            if (nowTime >= limitReadTime) {
-                limitReadTime = nowTime + std::chrono::seconds(1);
-                limitReadFilePos = filePos;
+                SleepFor(waitTime);
             }
         }
     }
 
+#ifdef __linux__
+    if (uring.IsWriting()) {
+        uring.Flush();
+    }
+#endif
+    writeThread.Flush();
+    if (output) {
+        fflush(output);
+    }
+    if (indexBuilding) {
+#ifdef _WIN32
+        std::unique_ptr<FILE, decltype(&fclose)> indexFile(_wfopen(indexName, L"wb"), fclose);
+#else
+        std::unique_ptr<FILE, decltype(&fclose)> indexFile(fopen(indexName, "wb"), fclose);
+#endif
+        if (!indexFile || !index.Save(indexFile.get(), filePos)) {
+            fprintf(stderr, "Warning: cannot write index.\n");
+        }
+    }
+#ifdef __linux__
+    writeback.Close();
+#endif
+    readThread.Close();
     CloseFile(openedFile, asyncContext);
     return 0;
 }
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t **argv)
+#else
+int main(int argc, char **argv)
+#endif
+{
+    return RunSession(argc, argv, false);
+}
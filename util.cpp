@@ -1,26 +1,109 @@
 #include "util.hpp"
 #include <algorithm>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define UTIL_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTIL_SSE2
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#define UTIL_TARGET_AVX2
+#else
+#define UTIL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define UTIL_NEON
+#endif
+
+namespace
+{
+template<int... I>
+struct INDEX_LIST {};
+template<int N, int... I>
+struct MAKE_INDEX_LIST : MAKE_INDEX_LIST<N - 1, N - 1, I...> {};
+template<int... I>
+struct MAKE_INDEX_LIST<0, I...> { typedef INDEX_LIST<I...> type; };
+
+// Slice-by-8 tables. table[n][i] is the CRC of the byte i followed by n zero bytes.
+struct CRC16_TABLE
+{
+    uint16_t table[8][256];
+};
+
+struct CRC32_TABLE
+{
+    uint32_t table[8][256];
+};
+
+constexpr uint16_t crc16_shift_bits(uint16_t c, int bits)
+{
+    return bits == 0 ? c : crc16_shift_bits(static_cast<uint16_t>((c << 1) ^ (c & 0x8000 ? 0x1021 : 0)), bits - 1);
+}
+
+constexpr uint16_t crc16_slice(int n, uint16_t i)
+{
+    return n == 0 ? crc16_shift_bits(static_cast<uint16_t>(i << 8), 8) :
+                    static_cast<uint16_t>((crc16_slice(n - 1, i) << 8) ^ crc16_slice(0, crc16_slice(n - 1, i) >> 8));
+}
+
+constexpr uint32_t crc32_shift_bits(uint32_t c, int bits)
+{
+    return bits == 0 ? c : crc32_shift_bits((c << 1) ^ (c & 0x80000000 ? 0x04c11db7 : 0), bits - 1);
+}
+
+constexpr uint32_t crc32_slice(int n, uint32_t i)
+{
+    return n == 0 ? crc32_shift_bits(i << 24, 8) : (crc32_slice(n - 1, i) << 8) ^ crc32_slice(0, crc32_slice(n - 1, i) >> 24);
+}
+
+template<int... I>
+constexpr CRC16_TABLE make_crc16_table(INDEX_LIST<I...>)
+{
+    return CRC16_TABLE{{{crc16_slice(0, I)...}, {crc16_slice(1, I)...}, {crc16_slice(2, I)...}, {crc16_slice(3, I)...},
+                        {crc16_slice(4, I)...}, {crc16_slice(5, I)...}, {crc16_slice(6, I)...}, {crc16_slice(7, I)...}}};
+}
+
+template<int... I>
+constexpr CRC32_TABLE make_crc32_table(INDEX_LIST<I...>)
+{
+    return CRC32_TABLE{{{crc32_slice(0, I)...}, {crc32_slice(1, I)...}, {crc32_slice(2, I)...}, {crc32_slice(3, I)...},
+                        {crc32_slice(4, I)...}, {crc32_slice(5, I)...}, {crc32_slice(6, I)...}, {crc32_slice(7, I)...}}};
+}
+
+constexpr CRC16_TABLE CRC16_CCITT = make_crc16_table(MAKE_INDEX_LIST<256>::type());
+constexpr CRC32_TABLE CRC32 = make_crc32_table(MAKE_INDEX_LIST<256>::type());
+}
+
 uint16_t calc_crc16_ccitt(const uint8_t *data, int data_size, uint16_t crc)
 {
-    for (int i = 0; i < data_size; ++i) {
-        uint16_t c = ((crc >> 8) ^ data[i]) << 8;
-        for (int j = 0; j < 8; ++j) {
-            c = (c << 1) ^ (c & 0x8000 ? 0x1021 : 0);
-        }
-        crc = (crc << 8) ^ c;
+    const uint16_t (&t)[8][256] = CRC16_CCITT.table;
+    int i = 0;
+    for (; i + 8 <= data_size; i += 8) {
+        crc = t[7][(crc >> 8) ^ data[i]] ^ t[6][(crc & 0xff) ^ data[i + 1]] ^ t[5][data[i + 2]] ^ t[4][data[i + 3]] ^
+              t[3][data[i + 4]] ^ t[2][data[i + 5]] ^ t[1][data[i + 6]] ^ t[0][data[i + 7]];
+    }
+    for (; i < data_size; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ t[0][(crc >> 8) ^ data[i]]);
     }
     return crc;
 }
 
 uint32_t calc_crc32(const uint8_t *data, int data_size, uint32_t crc)
 {
-    for (int i = 0; i < data_size; ++i) {
-        uint32_t c = ((crc >> 24) ^ data[i]) << 24;
-        for (int j = 0; j < 8; ++j) {
-            c = (c << 1) ^ (c & 0x80000000 ? 0x04c11db7 : 0);
-        }
-        crc = (crc << 8) ^ c;
+    const uint32_t (&t)[8][256] = CRC32.table;
+    int i = 0;
+    for (; i + 8 <= data_size; i += 8) {
+        crc ^= (static_cast<uint32_t>(data[i]) << 24) | (data[i + 1] << 16) | (data[i + 2] << 8) | data[i + 3];
+        crc = t[7][crc >> 24] ^ t[6][(crc >> 16) & 0xff] ^ t[5][(crc >> 8) & 0xff] ^ t[4][crc & 0xff] ^
+              t[3][data[i + 4]] ^ t[2][data[i + 5]] ^ t[1][data[i + 6]] ^ t[0][data[i + 7]];
+    }
+    for (; i < data_size; ++i) {
+        crc = (crc << 8) ^ t[0][(crc >> 24) ^ data[i]];
     }
     return crc;
 }
@@ -46,6 +129,7 @@ int extract_psi(PSI *psi, const uint8_t *payload, int payload_size, int unit_sta
         else {
             psi->continuity_counter = 0x20 | counter;
             psi->data_count = psi->version_number = 0;
+            psi->cache_matching = psi->cached_size != 0;
             copy_pos = 1 + pointer;
             copy_size -= copy_pos;
         }
@@ -59,6 +143,14 @@ int extract_psi(PSI *psi, const uint8_t *payload, int payload_size, int unit_sta
     }
     if (copy_size > 0 && copy_pos + copy_size <= payload_size) {
         copy_size = std::min(copy_size, static_cast<int>(sizeof(psi->data)) - psi->data_count);
+        if (psi->cache_matching) {
+            // Compare with the cached section before overwriting it
+            int compare_size = std::min(copy_size, psi->cached_size - psi->data_count);
+            if (compare_size > 0 &&
+                !std::equal(payload + copy_pos, payload + copy_pos + compare_size, psi->data + psi->data_count)) {
+                psi->cached_size = psi->cache_matching = 0;
+            }
+        }
         std::copy(payload + copy_pos, payload + copy_pos + copy_size, psi->data + psi->data_count);
         psi->data_count += copy_size;
     }
@@ -66,14 +158,19 @@ int extract_psi(PSI *psi, const uint8_t *payload, int payload_size, int unit_sta
     // If psi->version_number != 0, these fields are valid.
     if (psi->data_count >= 3) {
         int section_length = ((psi->data[1] & 0x03) << 8) | psi->data[2];
+        // The CRC of a repeated section has already been checked
+        int unchanged = psi->cache_matching && psi->cached_size == 3 + section_length;
         if (psi->data_count >= 3 + section_length &&
-            calc_crc32(psi->data, 3 + section_length) == 0 &&
-            section_length >= 3)
+            section_length >= 3 &&
+            (unchanged || calc_crc32(psi->data, 3 + section_length) == 0))
         {
             psi->table_id = psi->data[0];
             psi->section_length = section_length;
             psi->version_number = 0x20 | ((psi->data[5] >> 1) & 0x1f);
             psi->current_next_indicator = psi->data[5] & 0x01;
+            psi->cached_size = 3 + section_length;
+            psi->cache_matching = 1;
+            psi->unchanged = unchanged;
         }
     }
     return done;
@@ -87,7 +184,8 @@ void extract_pat(PAT *pat, const uint8_t *payload, int payload_size, int unit_st
         if (pat->psi.version_number &&
             pat->psi.current_next_indicator &&
             pat->psi.table_id == 0 &&
-            pat->psi.section_length >= 5)
+            pat->psi.section_length >= 5 &&
+            !pat->psi.unchanged)
         {
             // Update PAT
             const uint8_t *table = pat->psi.data;
@@ -109,6 +207,19 @@ void extract_pat(PAT *pat, const uint8_t *payload, int payload_size, int unit_st
     while (!done);
 }
 
+// Returns the PCR base (90kHz), or -1 if the packet has no PCR.
+int64_t extract_ts_pcr(const uint8_t *packet)
+{
+    if ((extract_ts_header_adaptation(packet) & 2) && packet[4] >= 6 && !!(packet[5] & 0x10)) {
+        return (packet[10] >> 7) |
+               (packet[9] << 1) |
+               (packet[8] << 9) |
+               (packet[7] << 17) |
+               (static_cast<int64_t>(packet[6]) << 25);
+    }
+    return -1;
+}
+
 int get_ts_payload_size(const uint8_t *packet)
 {
     int adaptation = extract_ts_header_adaptation(packet);
@@ -126,17 +237,166 @@ int get_ts_payload_size(const uint8_t *packet)
     return 0;
 }
 
-int resync_ts(const uint8_t *data, int data_size, int *unit_size)
+void decode_ts_headers(TS_HEADERS *headers)
 {
-    if (*unit_size == 188 || *unit_size == 192 || *unit_size == 204) {
-        for (int offset = 0; offset < data_size && offset < *unit_size; ++offset) {
-            int i = offset;
-            for (; i < data_size; i += *unit_size) {
-                if (data[i] != 0x47) {
+    size_t n = headers->packet.size();
+    headers->pid.resize(n);
+    headers->unit_start.resize(n);
+    headers->counter.resize(n);
+    headers->adaptation.resize(n);
+    headers->payload_offset.resize(n);
+    headers->pcr_flag.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t *packet = headers->packet[i];
+        headers->pid[i] = static_cast<uint16_t>(extract_ts_header_pid(packet));
+        headers->unit_start[i] = static_cast<uint8_t>(extract_ts_header_unit_start(packet));
+        headers->counter[i] = static_cast<uint8_t>(extract_ts_header_counter(packet));
+        headers->adaptation[i] = static_cast<uint8_t>(extract_ts_header_adaptation(packet));
+        headers->payload_offset[i] = static_cast<uint8_t>(188 - get_ts_payload_size(packet));
+        headers->pcr_flag[i] = (headers->adaptation[i] & 2) && packet[4] >= 6 && !!(packet[5] & 0x10);
+    }
+}
+
+namespace
+{
+// Packets following a candidate sync byte needed to synchronize
+const int SYNC_CONFIRM_COUNT = 8;
+
+// Returns the position of the first sync byte in [pos, end), or end if not found.
+int find_sync_byte(const uint8_t *data, int pos, int end)
+{
+#if defined(UTIL_SSE2)
+    const __m128i sync = _mm_set1_epi8(0x47);
+    for (; pos + 16 <= end; pos += 16) {
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos)), sync))) {
+            break;
+        }
+    }
+#elif defined(UTIL_NEON)
+    const uint8x16_t sync = vdupq_n_u8(0x47);
+    for (; pos + 16 <= end; pos += 16) {
+        if (vmaxvq_u8(vceqq_u8(vld1q_u8(data + pos), sync))) {
+            break;
+        }
+    }
+#endif
+    for (; pos < end && data[pos] != 0x47; ++pos);
+    return pos;
+}
+
+#ifdef UTIL_X86
+bool has_avx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, and whether the OS saves YMM registers
+    if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return !!(info[1] & 0x20);
+#else
+    return !!__builtin_cpu_supports("avx2");
+#endif
+}
+
+// Checks 8 sync bytes at a time. Returns the position where the check should continue.
+UTIL_TARGET_AVX2
+int skip_sync_stride_avx2(const uint8_t *data, int data_size, int pos, int unit_size)
+{
+    const __m256i index = _mm256_setr_epi32(0, unit_size, unit_size * 2, unit_size * 3,
+                                            unit_size * 4, unit_size * 5, unit_size * 6, unit_size * 7);
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    const __m256i sync = _mm256_set1_epi32(0x47);
+    // The gather reads 4 bytes at each position
+    for (; pos + unit_size * 7 + 4 <= data_size; pos += unit_size * 8) {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(data + pos), index, 1);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(v, mask), sync)) != -1) {
+            break;
+        }
+    }
+    return pos;
+}
+#endif
+
+// Returns true if all bytes at intervals of "unit_size" from "pos" are sync bytes.
+bool check_sync_stride(const uint8_t *data, int data_size, int pos, int unit_size)
+{
+#ifdef UTIL_X86
+    static const bool avx2 = has_avx2();
+    if (avx2) {
+        pos = skip_sync_stride_avx2(data, data_size, pos, unit_size);
+    }
+#endif
+    // Unrolled without branches in between
+    for (; pos + unit_size * 3 < data_size; pos += unit_size * 4) {
+        if ((data[pos] ^ 0x47) | (data[pos + unit_size] ^ 0x47) |
+            (data[pos + unit_size * 2] ^ 0x47) | (data[pos + unit_size * 3] ^ 0x47)) {
+            return false;
+        }
+    }
+    for (; pos < data_size; pos += unit_size) {
+        if (data[pos] != 0x47) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+bool CTsSyncTracker::Next(const uint8_t *data, int dataSize, int &pos, int &unitSize, bool flushing)
+{
+    if (m_locked) {
+        if (pos + unitSize > dataSize) {
+            return false;
+        }
+        if (data[pos] == 0x47 && (pos + unitSize == dataSize || data[pos + unitSize] == 0x47)) {
+            return true;
+        }
+        // Lost, drop this packet
+        m_locked = false;
+        ++pos;
+    }
+
+    for (pos = find_sync_byte(data, pos, dataSize); pos < dataSize; pos = find_sync_byte(data, pos + 1, dataSize)) {
+        bool undetermined = false;
+        for (int i = 0; i < 3; ++i) {
+            int size = unitSize != 0 ? unitSize : i == 0 ? 188 : i == 1 ? 192 : 204;
+            int count = 1;
+            for (; count < SYNC_CONFIRM_COUNT && pos + size * count < dataSize; ++count) {
+                if (data[pos + size * count] != 0x47) {
                     break;
                 }
             }
-            if (i >= data_size) {
+            if (count == SYNC_CONFIRM_COUNT || (pos + size * count >= dataSize && flushing && pos + size <= dataSize)) {
+                unitSize = size;
+                m_locked = true;
+                return true;
+            }
+            undetermined = undetermined || pos + size * count >= dataSize;
+            if (unitSize != 0) {
+                break;
+            }
+        }
+        if (undetermined) {
+            // Wait for more data
+            return false;
+        }
+    }
+    return false;
+}
+
+int resync_ts(const uint8_t *data, int data_size, int *unit_size)
+{
+    if (*unit_size == 188 || *unit_size == 192 || *unit_size == 204) {
+        int end = std::min(data_size, *unit_size);
+        for (int offset = find_sync_byte(data, 0, end); offset < end; offset = find_sync_byte(data, offset + 1, end)) {
+            if (check_sync_stride(data, data_size, offset, *unit_size)) {
                 return offset;
             }
         }
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <utility>
 #include <vector>
 
 struct PSI
@@ -13,6 +14,11 @@ struct PSI
     int current_next_indicator;
     int continuity_counter;
     int data_count;
+    // Size of the last valid section while it is left in data, and whether the section being extracted matches it so far
+    int cached_size;
+    int cache_matching;
+    // If nonzero, the valid section is byte-identical to the previous one and the state derived from it can be reused.
+    int unchanged;
     uint8_t data[1024];
 };
 
@@ -30,11 +36,103 @@ struct PAT
     PSI psi;
 };
 
+// Headers of a batch of TS packets decoded at once, as a struct of arrays shared by the stages.
+struct TS_HEADERS
+{
+    std::vector<const uint8_t *> packet;
+    std::vector<uint16_t> pid;
+    std::vector<uint8_t> unit_start;
+    std::vector<uint8_t> counter;
+    std::vector<uint8_t> adaptation;
+    // 188 if the packet has no payload
+    std::vector<uint8_t> payload_offset;
+    std::vector<uint8_t> pcr_flag;
+};
+
+// Ordered list of 188-byte TS packets.
+// Packets passed through unchanged are only referenced, so the referenced memory must be kept until Clear().
+class CPacketList
+{
+public:
+    CPacketList() : m_bufSize(0) {}
+    // Claims a 188-byte slot for a synthesized or modified packet, which the caller must fill entirely.
+    // The slot is valid until the next call. Slots are reused after Clear() without reallocation.
+    uint8_t *AddSlot()
+    {
+        if (m_bufSize == m_buf.size()) {
+            m_buf.resize(m_buf.empty() ? 188 * 64 : m_buf.size() * 2);
+        }
+        m_bufSize += 188;
+        return m_buf.data() + m_bufSize - 188;
+    }
+    void AddRef(const uint8_t *packet) { m_refs.push_back(std::make_pair(packet, m_bufSize)); }
+    bool Empty() const { return m_bufSize == 0 && m_refs.empty(); }
+    void Clear() { m_bufSize = 0; m_refs.clear(); }
+
+    template<class F>
+    void ForEach(F f) const
+    {
+        size_t pos = 0;
+        for (auto it = m_refs.begin(); it != m_refs.end(); ++it) {
+            for (; pos < it->second; pos += 188) {
+                f(m_buf.data() + pos);
+            }
+            f(it->first);
+        }
+        for (; pos < m_bufSize; pos += 188) {
+            f(m_buf.data() + pos);
+        }
+    }
+
+    // Calls f(data, size) for each run of packets that are contiguous in memory.
+    template<class F>
+    void ForEachRun(F f) const
+    {
+        const uint8_t *runData = nullptr;
+        size_t runSize = 0;
+        ForEach([&](const uint8_t *packet) {
+            if (runData + runSize != packet) {
+                if (runSize != 0) {
+                    f(runData, runSize);
+                }
+                runData = packet;
+                runSize = 0;
+            }
+            runSize += 188;
+        });
+        if (runSize != 0) {
+            f(runData, runSize);
+        }
+    }
+
+private:
+    std::vector<uint8_t> m_buf;
+    size_t m_bufSize;
+    std::vector<std::pair<const uint8_t *, size_t>> m_refs;
+};
+
+// Keeps synchronization of TS packets across reads, checking only the sync bytes of new packets.
+// When it is lost, the stream is resynchronized around the bad packet so that the packets before and after it survive.
+class CTsSyncTracker
+{
+public:
+    CTsSyncTracker() : m_locked(false) {}
+    // Finds the packet at or after "pos". "unitSize" may be 0 (unknown) and is set when synchronized.
+    // Returns false if no more packets are determined, in which case the data from "pos" should be kept for the next
+    // call. If "flushing", no more data follows and fewer packets are needed to synchronize.
+    bool Next(const uint8_t *data, int dataSize, int &pos, int &unitSize, bool flushing);
+
+private:
+    bool m_locked;
+};
+
 uint16_t calc_crc16_ccitt(const uint8_t *data, int data_size, uint16_t crc = 0);
 uint32_t calc_crc32(const uint8_t *data, int data_size, uint32_t crc = 0xffffffff);
 int extract_psi(PSI *psi, const uint8_t *payload, int payload_size, int unit_start, int counter);
 void extract_pat(PAT *pat, const uint8_t *payload, int payload_size, int unit_start, int counter);
 int get_ts_payload_size(const uint8_t *packet);
+int64_t extract_ts_pcr(const uint8_t *packet);
+void decode_ts_headers(TS_HEADERS *headers);
 int resync_ts(const uint8_t *data, int data_size, int *unit_size);
 
 inline int extract_ts_header_unit_start(const uint8_t *packet) { return !!(packet[1] & 0x40); }
@@ -52,13 +150,26 @@ inline bool read_bool(const uint8_t *data, size_t &pos)
     return !!extract_bit(data, pos++);
 }
 
+// Compilers usually merge this into a single load.
+inline uint64_t load_be64(const uint8_t *data)
+{
+    return (static_cast<uint64_t>(data[0]) << 56) |
+           (static_cast<uint64_t>(data[1]) << 48) |
+           (static_cast<uint64_t>(data[2]) << 40) |
+           (static_cast<uint64_t>(data[3]) << 32) |
+           (static_cast<uint64_t>(data[4]) << 24) |
+           (static_cast<uint64_t>(data[5]) << 16) |
+           (static_cast<uint64_t>(data[6]) << 8) |
+           data[7];
+}
+
+// Reads "n" (<= 31) bits at once. 8 bytes from the byte at "pos" must be readable.
 inline int read_bits(const uint8_t *data, size_t &pos, int n)
 {
-    int r = 0;
-    while (--n >= 0) {
-        r |= extract_bit(data, pos++) << n;
-    }
-    return r;
+    uint64_t word = load_be64(data + (pos >> 3)) << (pos & 7);
+    pos += n;
+    // Shift twice so that "n" may be 0
+    return static_cast<int>(word >> (63 - n) >> 1);
 }
 
 #endif